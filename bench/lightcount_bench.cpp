@@ -0,0 +1,124 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+// Light count stress test for the clustered point lights: renders a 48x48 garden through
+// SceneRenderer with 0 to 1024 lights scattered over it and reports the CPU assignment time,
+// GPU frame time and how many lights the busiest cluster ended up with. Frame cost should follow
+// lights per cluster, not the total. Renders offscreen at 1280x720, no window needed.
+// Usage: lightcount_bench [frames]
+//
+
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QThread>
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include "offscreentarget.h"
+#include "model/gardenmodel.h"
+#include "renderer/assetcache.h"
+#include "renderer/scenerenderer.h"
+
+namespace {
+
+constexpr int GardenSize = 48;
+constexpr int Width = 1280;
+constexpr int Height = 720;
+
+std::vector<GardenLight> scatterLights(int count, std::mt19937 &rng) {
+    std::uniform_real_distribution<float> ground(0.0f, float(GardenSize));
+    std::uniform_real_distribution<float> height(0.3f, 2.0f);
+    std::uniform_real_distribution<float> hue(0.3f, 1.0f);
+    std::vector<GardenLight> lights;
+    for (int i = 0; i < count; ++i) {
+        GardenLight light;
+        light.position = QVector3D(ground(rng), height(rng), ground(rng));
+        light.color = QVector3D(hue(rng), hue(rng), hue(rng));
+        light.radius = 2.5f;
+        lights.push_back(light);
+    }
+    return lights;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    QGuiApplication app(argc, argv);
+    int frames = argc > 1 ? std::max(1, atoi(argv[1])) : 20;
+
+    OffscreenTarget target(Width, Height);
+    if (!target.isValid()) {
+        std::fprintf(stderr, "%s\n", target.getError());
+        return 1;
+    }
+    QOpenGLFunctions_3_3_Core &gl = target.gl();
+
+    // Every third cell planted, so there's geometry at all depths for the lights to land on
+    GardenModel garden(GardenSize);
+    garden.setModelDirectory(GARDEN_SOURCE_DIR "/models/plants");
+    for (int x = 0; x < GardenSize; ++x) {
+        for (int z = 0; z < GardenSize; ++z) {
+            if ((x + z) % 3 == 0) garden.addPlant(Plant::Type((x * 7 + z) % 3), QPoint(x, z));
+        }
+    }
+
+    int exitCode = 0;
+    {
+        SceneRenderer scene(GARDEN_SOURCE_DIR);
+        if (!scene.initialize()) return 1;
+        scene.syncPlants(garden);
+        while (AssetCache::instance().loader().isBusy()) {
+            AssetCache::instance().processUploads(1000000000);
+            QThread::msleep(1);
+        }
+        AssetCache::instance().processUploads(1000000000);
+
+        // Looking down over the whole garden so nearly every light is on screen
+        Camera camera(float(Width) / float(Height));
+        camera.setPosition(QVector3D(GardenSize * 0.5f, GardenSize * 0.8f, GardenSize * 1.3f));
+        camera.setTarget(QVector3D(GardenSize * 0.5f, 0.0f, GardenSize * 0.45f));
+
+        GLuint query;
+        gl.glGenQueries(1, &query);
+
+        std::printf("%6s %8s %10s %10s %10s %10s %9s %8s\n", "lights", "visible", "entries", "busiest",
+                    "dropped", "assign us", "gpu ms", "total ms");
+
+        std::mt19937 rng(11);
+        for (int count : {0, 16, 64, 256, 1024}) {
+            scene.setLights(scatterLights(count, rng));
+
+            double assignUs = 0.0, gpuMs = 0.0, totalMs = 0.0;
+            for (int frame = 0; frame <= frames; ++frame) {
+                // Nudging the camera every frame makes the clusters reassign like they would in use
+                camera.setPosition(QVector3D(GardenSize * 0.5f + float(frame % 2) * 0.01f, GardenSize * 0.8f,
+                                             GardenSize * 1.3f));
+
+                QElapsedTimer timer;
+                timer.start();
+                gl.glBeginQuery(GL_TIME_ELAPSED, query);
+                scene.render(camera, GardenSize);
+                gl.glEndQuery(GL_TIME_ELAPSED);
+                gl.glFinish();
+                qint64 total = timer.nsecsElapsed();
+
+                GLuint64 gpuNs = 0;
+                gl.glGetQueryObjectui64v(query, GL_QUERY_RESULT, &gpuNs);
+                if (frame == 0) continue;  // warm-up
+                assignUs += scene.lastLightStats().assignNs / 1e3;
+                gpuMs += gpuNs / 1e6;
+                totalMs += total / 1e6;
+            }
+
+            LightClusters::Stats stats = scene.lastLightStats();
+            std::printf("%6d %8d %10d %10d %10d %10.1f %9.2f %8.2f\n", count, stats.visibleLights,
+                        stats.assignments, stats.busiestCluster, stats.dropped,
+                        assignUs / frames, gpuMs / frames, totalMs / frames);
+            if (count > 0 && stats.visibleLights == 0) exitCode = 1;  // camera pointed somewhere wrong
+        }
+
+        gl.glDeleteQueries(1, &query);
+    }
+
+    return exitCode;
+}
@@ -0,0 +1,135 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+// Compares the mapped ObjParser against the QTextStream/QString::split loader that
+// Model::loadModel used before it. Usage: objparser_bench [iterations] [models dir]
+//
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <cstdio>
+#include "model/objparser.h"
+
+namespace {
+
+// The old line based loader, kept here only as the baseline to measure against
+bool legacyParse(const QString &objPath, MeshData &mesh) {
+    QFile file(objPath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return false;
+    }
+
+    std::vector<QVector3D> positions;
+    std::vector<QVector3D> normals;
+    std::vector<QVector2D> texCoords;
+    mesh.vertices.clear();
+    mesh.indices.clear();
+
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        QString line = in.readLine().trimmed();
+        QStringList parts = line.split(' ', Qt::SkipEmptyParts);
+
+        if (parts.isEmpty()) continue;
+
+        if (parts[0] == "mtllib") {
+            mesh.mtlPath = QFileInfo(objPath).path() + "/" + parts[1];
+        }
+        else if (parts[0] == "v") {
+            positions.push_back(QVector3D(parts[1].toFloat(), parts[2].toFloat(), parts[3].toFloat()));
+        }
+        else if (parts[0] == "vt") {
+            texCoords.push_back(QVector2D(parts[1].toFloat(), parts[2].toFloat()));
+        }
+        else if (parts[0] == "vn") {
+            normals.push_back(QVector3D(parts[1].toFloat(), parts[2].toFloat(), parts[3].toFloat()));
+        }
+        else if (parts[0] == "f") {
+            for (int i = 1; i <= 3; ++i) {
+                QStringList indices = parts[i].split('/');
+
+                Vertex vertex;
+                vertex.position = positions[indices[0].toInt() - 1];
+                if (indices.size() > 1 && !indices[1].isEmpty()) {
+                    vertex.texCoords = texCoords[indices[1].toInt() - 1];
+                }
+                if (indices.size() > 2) {
+                    vertex.normal = normals[indices[2].toInt() - 1];
+                }
+
+                mesh.vertices.push_back(vertex);
+                mesh.indices.push_back(mesh.indices.size());
+            }
+        }
+    }
+
+    // The old path also split the MTL the same way
+    QFile mtl(mesh.mtlPath);
+    if (mtl.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QTextStream mtlIn(&mtl);
+        while (!mtlIn.atEnd()) {
+            QStringList parts = mtlIn.readLine().trimmed().split(' ', Qt::SkipEmptyParts);
+            if (parts.size() > 3 && parts[0] == "Kd") {
+                mesh.material.diffuse = QVector3D(parts[1].toFloat(), parts[2].toFloat(), parts[3].toFloat());
+            }
+        }
+    }
+    return true;
+}
+
+template<typename Fn>
+double averageMicros(int iterations, Fn &&fn) {
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < iterations; ++i) {
+        fn();
+    }
+    return double(timer.nsecsElapsed()) / 1000.0 / iterations;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    int iterations = argc > 1 ? QString(argv[1]).toInt() : 200;
+    QString modelsDir = argc > 2 ? QString(argv[2]) : QString(GARDEN_SOURCE_DIR "/models");
+    if (iterations <= 0) iterations = 200;
+
+    const QStringList files = {
+            modelsDir + "/plants/carrot.obj",
+            modelsDir + "/plants/tomato.obj",
+            modelsDir + "/bed.obj",
+    };
+
+    std::printf("%-12s %10s %10s %10s %10s %8s\n", "model", "corners", "vertices", "legacy us", "mapped us", "speedup");
+
+    ObjParser parser;
+    for (const QString &path : files) {
+        MeshData legacyMesh;
+        MeshData mappedMesh;
+        if (!legacyParse(path, legacyMesh) || !parser.parse(path, mappedMesh)) {
+            std::printf("%-12s failed to load: %s\n", qPrintable(QFileInfo(path).fileName()),
+                        qPrintable(parser.getError()));
+            continue;
+        }
+
+        // Legacy emits a vertex per corner, the mapped parser dedups, so compare triangles
+        if (legacyMesh.indices.size() != mappedMesh.indices.size()) {
+            std::printf("%-12s triangle count mismatch (%zu legacy vs %zu mapped)\n",
+                        qPrintable(QFileInfo(path).fileName()),
+                        legacyMesh.indices.size() / 3, mappedMesh.indices.size() / 3);
+        }
+
+        double legacy = averageMicros(iterations, [&]() { legacyParse(path, legacyMesh); });
+        double mapped = averageMicros(iterations, [&]() { parser.parse(path, mappedMesh); });
+
+        std::printf("%-12s %10zu %10zu %10.1f %10.1f %7.1fx\n", qPrintable(QFileInfo(path).fileName()),
+                    legacyMesh.vertices.size(), mappedMesh.vertices.size(), legacy, mapped, legacy / mapped);
+    }
+
+    return 0;
+}
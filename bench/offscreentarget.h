@@ -0,0 +1,87 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+// Shared setup for the GL benches and garden_snapshot: a 3.3 core context current on an
+// offscreen surface, rendering into a width x height FBO (RGBA8 colour, 24 bit depth) that
+// stays bound with the viewport covering it. Declare it before anything that owns GL objects
+// so those are gone before the context is.
+//
+
+#ifndef GARDEN_SIMULATION_OFFSCREENTARGET_H
+#define GARDEN_SIMULATION_OFFSCREENTARGET_H
+
+#pragma once
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions_3_3_Core>
+#include <QSurfaceFormat>
+
+class OffscreenTarget {
+
+public:
+    OffscreenTarget(int width, int height) : m_width(width), m_height(height) {
+        QSurfaceFormat format;
+        format.setVersion(3, 3);
+        format.setProfile(QSurfaceFormat::CoreProfile);
+        format.setDepthBufferSize(24);
+        QSurfaceFormat::setDefaultFormat(format);
+
+        m_surface.create();
+        if (!m_context.create() || !m_context.makeCurrent(&m_surface)) {
+            m_error = "no OpenGL 3.3 context";
+            return;
+        }
+        m_gl.initializeOpenGLFunctions();
+
+        m_gl.glGenFramebuffers(1, &m_fbo);
+        m_gl.glGenRenderbuffers(1, &m_colour);
+        m_gl.glGenRenderbuffers(1, &m_depth);
+        m_gl.glBindRenderbuffer(GL_RENDERBUFFER, m_colour);
+        m_gl.glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        m_gl.glBindRenderbuffer(GL_RENDERBUFFER, m_depth);
+        m_gl.glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+        m_gl.glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+        m_gl.glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colour);
+        m_gl.glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depth);
+        if (m_gl.glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            m_error = "framebuffer incomplete";
+            return;
+        }
+        m_gl.glViewport(0, 0, width, height);
+        m_valid = true;
+    }
+
+    ~OffscreenTarget() {
+        if (!m_fbo || !m_context.makeCurrent(&m_surface)) return;
+        m_gl.glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        m_gl.glDeleteFramebuffers(1, &m_fbo);
+        m_gl.glDeleteRenderbuffers(1, &m_colour);
+        m_gl.glDeleteRenderbuffers(1, &m_depth);
+    }
+
+    OffscreenTarget(const OffscreenTarget&) = delete;
+    OffscreenTarget& operator=(const OffscreenTarget&) = delete;
+
+    bool isValid() const { return m_valid; }
+    const char* getError() const { return m_error; }
+
+    QOpenGLFunctions_3_3_Core& gl() { return m_gl; }
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+
+private:
+    // Surface declared first so it outlives the context
+    QOffscreenSurface m_surface;
+    QOpenGLContext m_context;
+    QOpenGLFunctions_3_3_Core m_gl;
+    GLuint m_fbo = 0;
+    GLuint m_colour = 0;
+    GLuint m_depth = 0;
+    int m_width;
+    int m_height;
+    bool m_valid = false;
+    const char *m_error = "";
+};
+
+
+#endif //GARDEN_SIMULATION_OFFSCREENTARGET_H
@@ -0,0 +1,89 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+// Hover picking cost on big gardens: GridPicker against the old per call matrix inversions plus
+// ground plane hit, over a sweep of cursor positions across the view. Gardens go up to 316x316
+// (about 100k cells) with a plant in every other cell, so most rays cross plenty of them.
+// No GL needed. Usage: picking_bench [picks per garden]
+//
+
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include "renderer/camera.h"
+#include "renderer/gridpicker.h"
+
+namespace {
+
+constexpr int Width = 1280;
+constexpr int Height = 720;
+
+// What GardenGLWidget::screenToWorld did per mouse move before the picker
+QVector3D legacyGroundHit(const Camera &camera, const QPointF &position) {
+    float x = float(2.0 * position.x() / Width - 1.0);
+    float y = float(1.0 - 2.0 * position.y() / Height);
+    QVector4D rayEye = camera.getProjectionMatrix().inverted() * QVector4D(x, y, -1.0f, 1.0f);
+    rayEye.setZ(-1.0f);
+    rayEye.setW(0.0f);
+    QVector3D direction = (camera.getViewMatrix().inverted() * rayEye).toVector3D().normalized();
+    QVector3D origin = camera.getPosition();
+    return origin + direction * (-origin.y() / direction.y());
+}
+
+QPointF cursorAt(int i, int picks) {
+    // Zig-zag over the whole viewport
+    int columns = std::max(1, int(std::sqrt(double(picks))));
+    int row = i / columns, column = i % columns;
+    return QPointF((column + 0.5) * Width / columns, (row + 0.5) * Height / std::max(1, picks / columns));
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    QGuiApplication app(argc, argv);
+    int picks = argc > 1 ? std::max(1, atoi(argv[1])) : 100000;
+
+    std::printf("%6s %8s %8s %12s %12s %10s %10s\n", "size", "cells", "plants", "legacy us", "picker us",
+                "on beds", "on plants");
+    for (int size : {10, 32, 100, 316}) {
+        GridPicker picker;
+        picker.setGridSize(size);
+        for (int x = 0; x < size; ++x) {
+            for (int z = 0; z < size; ++z) {
+                if ((x + z) % 2 != 0) continue;
+                // Taller towards the middle so some of them stand in front of others
+                float height = 0.4f + 1.6f * float((x * 7 + z * 3) % 5) / 4.0f;
+                picker.setPlantBounds(QPoint(x, z), Aabb(QVector3D(x + 0.2f, 0.0f, z + 0.2f),
+                                                         QVector3D(x + 0.8f, height, z + 0.8f)));
+            }
+        }
+
+        // Low over one corner looking across the garden, the long rays are the expensive ones
+        Camera camera(float(Width) / float(Height));
+        camera.setPosition(QVector3D(-2.0f, size * 0.15f + 2.0f, -2.0f));
+        camera.setTarget(QVector3D(size * 0.6f, 0.0f, size * 0.6f));
+
+        QElapsedTimer timer;
+        volatile float sink = 0.0f;  // keeps the legacy loop from being optimised away
+        timer.start();
+        for (int i = 0; i < picks; ++i) {
+            sink = sink + legacyGroundHit(camera, cursorAt(i, picks)).x();
+        }
+        double legacyUs = timer.nsecsElapsed() / 1e3 / picks;
+
+        int onBeds = 0, onPlants = 0;
+        timer.start();
+        for (int i = 0; i < picks; ++i) {
+            GridPicker::Hit hit = picker.pick(GridPicker::screenRay(camera, cursorAt(i, picks), QSize(Width, Height)));
+            onBeds += hit.cell.x() >= 0;
+            onPlants += hit.hitsPlant();
+        }
+        double pickerUs = timer.nsecsElapsed() / 1e3 / picks;
+
+        std::printf("%6d %8d %8d %12.3f %12.3f %10d %10d\n", size, size * size, picker.plantCount(), legacyUs,
+                    pickerUs, onBeds, onPlants);
+    }
+    return 0;
+}
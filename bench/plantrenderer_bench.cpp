@@ -0,0 +1,165 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+// Draw calls and GPU frame time for PlantRenderer against drawing every plant on its own
+// (the old paintGL loop), at 1k, 10k and 100k plants spread over the three species. Also
+// times the incremental add/remove path. Renders offscreen, so no window is needed.
+// Usage: plantrenderer_bench [frames]
+//
+
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QThread>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include "offscreentarget.h"
+#include "renderer/assetcache.h"
+#include "renderer/modeluniforms.h"
+#include "renderer/normalmatrix.h"
+#include "renderer/plantrenderer.h"
+#include "renderer/shader.h"
+#include "renderer/uniformblocks.h"
+
+namespace {
+
+struct PlacedPlant {
+    QPoint cell;
+    Plant::Type type;
+    QMatrix4x4 transform;
+};
+
+std::vector<PlacedPlant> makeGarden(int count) {
+    // Square-ish grid filled row by row, species cycling so each gets a third
+    int side = int(std::ceil(std::sqrt(double(count))));
+    std::vector<PlacedPlant> plants;
+    plants.reserve(size_t(count));
+    for (int i = 0; i < count; ++i) {
+        QPoint cell(i % side, i / side);
+        QMatrix4x4 transform;
+        transform.translate(cell.x() + 0.5f, 0.0f, cell.y() + 0.5f);
+        plants.push_back({cell, Plant::Type(i % PlantRenderer::SpeciesCount), transform});
+    }
+    return plants;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    QGuiApplication app(argc, argv);
+    int frames = argc > 1 ? std::max(1, atoi(argv[1])) : 20;
+
+    // Small target, this is about submission cost not fill rate
+    OffscreenTarget target(256, 256);
+    if (!target.isValid()) {
+        std::fprintf(stderr, "%s\n", target.getError());
+        return 1;
+    }
+    QOpenGLFunctions_3_3_Core &gl = target.gl();
+    gl.glEnable(GL_DEPTH_TEST);
+
+    Shader shader(GARDEN_SOURCE_DIR "/shaders/model.vert", GARDEN_SOURCE_DIR "/shaders/model.frag");
+    if (!shader.compile()) {
+        std::fprintf(stderr, "model shader failed to compile\n");
+        return 1;
+    }
+
+    // Load the species meshes through the cache like the app does, then wait for them
+    static const char *paths[PlantRenderer::SpeciesCount] = {
+            GARDEN_SOURCE_DIR "/models/plants/carrot.obj",
+            GARDEN_SOURCE_DIR "/models/plants/pumpkin.obj",
+            GARDEN_SOURCE_DIR "/models/plants/tomato.obj",
+    };
+    std::shared_ptr<Mesh> meshes[PlantRenderer::SpeciesCount];
+    for (int i = 0; i < PlantRenderer::SpeciesCount; ++i) {
+        meshes[i] = AssetCache::instance().mesh(paths[i]);
+        if (!meshes[i]) {
+            std::fprintf(stderr, "missing %s\n", paths[i]);
+            return 1;
+        }
+    }
+    while (AssetCache::instance().loader().isBusy()) {
+        AssetCache::instance().processUploads(1000000000);
+        QThread::msleep(1);
+    }
+
+    QMatrix4x4 view;
+    view.lookAt(QVector3D(-20.0f, 40.0f, -20.0f), QVector3D(50.0f, 0.0f, 50.0f), QVector3D(0.0f, 1.0f, 0.0f));
+    QMatrix4x4 projection;
+    projection.perspective(45.0f, 1.0f, 0.1f, 1000.0f);
+
+    StreamBuffer stream(64 * 1024);
+    FrameUniformBuffer frameUniforms;
+    FrameBlock frameBlock(view, projection, QVector3D(-20.0f, 40.0f, -20.0f), QVector3D(5.0f, 8.0f, 5.0f),
+                          QVector3D(1.0f, 1.0f, 1.0f), 0.0f);
+
+    auto beginFrame = [&]() {
+        gl.glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        stream.endFrame();  // the last frame's slice
+        frameUniforms.update(frameBlock, stream);
+        shader.bind();
+        shader.setBool("isPreview", false);
+    };
+
+    std::printf("%8s %22s %26s %14s %16s\n", "plants", "draw calls inst/each", "frame ms inst/each",
+                "add us/plant", "remove us/plant");
+
+    std::mt19937 rng(7);
+    for (int count : {1000, 10000, 100000}) {
+        std::vector<PlacedPlant> garden = makeGarden(count);
+        PlantRenderer renderer;
+        QElapsedTimer timer;
+
+        timer.start();
+        for (const PlacedPlant &plant : garden) {
+            renderer.addPlant(plant.cell, plant.type, meshes[plant.type], plant.transform);
+        }
+        double addUs = timer.nsecsElapsed() / 1e3 / count;
+
+        // Instanced, the first frame also uploads the buffers so it's left out
+        int instancedCalls = 0;
+        double instancedMs = 0.0;
+        for (int frame = 0; frame <= frames; ++frame) {
+            timer.start();
+            beginFrame();
+            instancedCalls = renderer.draw(&shader);
+            gl.glFinish();
+            if (frame > 0) instancedMs += timer.nsecsElapsed() / 1e6;
+        }
+        instancedMs /= frames;
+
+        // One draw per plant, what paintGL did before
+        const ModelUniforms &uniforms = shader.handles<ModelUniforms>();
+        double eachMs = 0.0;
+        for (int frame = 0; frame < frames; ++frame) {
+            timer.start();
+            beginFrame();
+            for (const PlacedPlant &plant : garden) {
+                shader.set(uniforms.model, plant.transform);
+                shader.set(uniforms.normalMatrix, NormalMatrix::of(plant.transform));
+                meshes[plant.type]->draw(&shader);
+            }
+            gl.glFinish();
+            eachMs += timer.nsecsElapsed() / 1e6;
+        }
+        eachMs /= frames;
+
+        // Remove half in random order, each is a swap remove and a one slot upload
+        std::shuffle(garden.begin(), garden.end(), rng);
+        int removals = count / 2;
+        timer.start();
+        for (int i = 0; i < removals; ++i) {
+            renderer.removePlant(garden[size_t(i)].cell);
+        }
+        beginFrame();
+        renderer.draw(&shader);
+        gl.glFinish();
+        double removeUs = timer.nsecsElapsed() / 1e3 / removals;
+
+        std::printf("%8d %11d / %-8d %12.2f / %-11.2f %14.3f %16.3f\n", count, instancedCalls, count,
+                    instancedMs, eachMs, addUs, removeUs);
+    }
+
+    return 0;
+}
@@ -0,0 +1,133 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+// Vertex stage cost of model.vert with the normal matrix from the CPU (instance attribute or
+// uniform) against the old per-vertex mat3(transpose(inverse(model))). The old shader is
+// model.vert with that one line put back. Renders the tomato into a tiny offscreen target so
+// fragment work stays out of the numbers. Meant for a software rasterizer, e.g.
+//   LIBGL_ALWAYS_SOFTWARE=1 GALLIUM_DRIVER=llvmpipe vertexstage_bench [instances] [frames]
+//
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QGuiApplication>
+#include <QTemporaryDir>
+#include <QThread>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include "offscreentarget.h"
+#include "renderer/assetcache.h"
+#include "renderer/instancebatch.h"
+#include "renderer/modeluniforms.h"
+#include "renderer/normalmatrix.h"
+#include "renderer/shader.h"
+#include "renderer/uniformblocks.h"
+
+int main(int argc, char *argv[]) {
+    QGuiApplication app(argc, argv);
+    int instances = argc > 1 ? std::max(1, atoi(argv[1])) : 2000;
+    int frames = argc > 2 ? std::max(1, atoi(argv[2])) : 10;
+
+    // 8x8 target, nearly every triangle covers no pixel centre
+    OffscreenTarget target(8, 8);
+    if (!target.isValid()) {
+        std::fprintf(stderr, "%s\n", target.getError());
+        return 1;
+    }
+    QOpenGLFunctions_3_3_Core &gl = target.gl();
+    std::printf("renderer: %s\n", reinterpret_cast<const char*>(gl.glGetString(GL_RENDERER)));
+    gl.glEnable(GL_DEPTH_TEST);
+
+    // The old shader, model.vert with the inverse back in
+    QFile source(GARDEN_SOURCE_DIR "/shaders/model.vert");
+    if (!source.open(QIODevice::ReadOnly)) {
+        std::fprintf(stderr, "missing model.vert\n");
+        return 1;
+    }
+    QByteArray inverseSource = source.readAll();
+    inverseSource.replace("Normal = normalTransform * normal;", "Normal = mat3(transpose(inverse(modelMatrix))) * normal;");
+    QTemporaryDir scratch;
+    QFile inverseFile(scratch.path() + "/model_inverse.vert");
+    if (!inverseFile.open(QIODevice::WriteOnly) || inverseFile.write(inverseSource) != inverseSource.size()) {
+        std::fprintf(stderr, "couldn't write the inverse shader\n");
+        return 1;
+    }
+    inverseFile.close();
+
+    Shader cpuShader(GARDEN_SOURCE_DIR "/shaders/model.vert", GARDEN_SOURCE_DIR "/shaders/model.frag");
+    Shader inverseShader(inverseFile.fileName(), GARDEN_SOURCE_DIR "/shaders/model.frag");
+    if (!cpuShader.compile() || !inverseShader.compile()) {
+        std::fprintf(stderr, "model shader failed to compile\n");
+        return 1;
+    }
+
+    std::shared_ptr<Mesh> mesh = AssetCache::instance().mesh(GARDEN_SOURCE_DIR "/models/plants/tomato.obj");
+    while (AssetCache::instance().loader().isBusy()) {
+        AssetCache::instance().processUploads(1000000000);
+        QThread::msleep(1);
+    }
+    if (!mesh || !mesh->isResident()) {
+        std::fprintf(stderr, "tomato mesh didn't load\n");
+        return 1;
+    }
+
+    // Rotated and unevenly scaled so the inverse has real work to do
+    std::vector<QMatrix4x4> transforms;
+    InstanceBatch batch;
+    int side = int(std::ceil(std::sqrt(double(instances))));
+    for (int i = 0; i < instances; ++i) {
+        QMatrix4x4 transform;
+        transform.translate(float(i % side), 0.0f, float(i / side));
+        transform.rotate(float(i * 37 % 360), 0.0f, 1.0f, 0.0f);
+        transform.scale(1.0f, 1.0f + 0.1f * float(i % 5), 1.0f);
+        transforms.push_back(transform);
+        batch.append(InstanceData(transform, QVector4D(1.0f, 1.0f, 1.0f, 1.0f)));
+    }
+
+    QMatrix4x4 view;
+    view.lookAt(QVector3D(-20.0f, 40.0f, -20.0f), QVector3D(50.0f, 0.0f, 50.0f), QVector3D(0.0f, 1.0f, 0.0f));
+    QMatrix4x4 projection;
+    projection.perspective(45.0f, 1.0f, 0.1f, 1000.0f);
+    StreamBuffer stream(64 * 1024);
+    FrameUniformBuffer frameUniforms;
+    frameUniforms.update(FrameBlock(view, projection, QVector3D(-20.0f, 40.0f, -20.0f), QVector3D(5.0f, 8.0f, 5.0f),
+                                    QVector3D(1.0f, 1.0f, 1.0f), 0.0f), stream);
+
+    // Instanced reads the per instance attribute, single draws the uniform
+    auto timeFrames = [&](Shader &shader, bool instanced) {
+        QElapsedTimer timer;
+        double total = 0.0;
+        for (int frame = 0; frame <= frames; ++frame) {
+            timer.start();
+            gl.glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            shader.bind();
+            const ModelUniforms &uniforms = shader.handles<ModelUniforms>();
+            shader.set(uniforms.isPreview, false);
+            if (instanced) {
+                batch.draw(mesh.get(), &shader);
+            } else {
+                for (const QMatrix4x4 &transform : transforms) {
+                    shader.set(uniforms.model, transform);
+                    shader.set(uniforms.normalMatrix, NormalMatrix::of(transform));
+                    mesh->draw(&shader);
+                }
+            }
+            gl.glFinish();
+            if (frame > 0) total += timer.nsecsElapsed() / 1e6;  // first frame warms up
+        }
+        return total / frames;
+    };
+
+    double vertices = double(mesh->getIndexCount()) * instances;
+    std::printf("%d instances, %.0f vertices per frame\n", instances, vertices);
+    std::printf("%-10s %18s %18s %14s\n", "draw", "inverse ms", "cpu normal ms", "ns/vertex");
+    for (bool instanced : {true, false}) {
+        double inverseMs = timeFrames(inverseShader, instanced);
+        double cpuMs = timeFrames(cpuShader, instanced);
+        std::printf("%-10s %18.2f %18.2f %6.2f -> %-6.2f\n", instanced ? "instanced" : "single",
+                    inverseMs, cpuMs, inverseMs * 1e6 / vertices, cpuMs * 1e6 / vertices);
+    }
+
+    return 0;
+}
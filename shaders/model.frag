@@ -4,6 +4,8 @@ out vec4 FragColor;
 in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoords;
+in vec4 Tint;
+in vec4 ClipPos;
 
 uniform sampler2D diffuseMap;
 uniform bool hasDiffuseMap;
@@ -11,23 +13,68 @@ uniform bool isPreview;
 uniform float previewAlpha;
 uniform vec3 previewColor;
 
-struct Material {
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-    float shininess;
+// Shared by every program, filled once per frame (see FrameBlock in uniformblocks.h)
+layout (std140) uniform Frame {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPos;
+    vec4 lightPos;
+    vec4 lightColor;
+    float time;
+    vec4 clusters;  // point light slices: x log depth scale, y bias, z light count
 };
 
-uniform Material material;
-uniform vec3 lightPos;
-uniform vec3 lightColor;
-uniform vec3 viewPos;
+// One buffer per mesh (see MaterialBlock in uniformblocks.h), specular.w is the shininess
+layout (std140) uniform Material {
+    vec4 ambient;
+    vec4 diffuse;
+    vec4 specular;
+} material;
+
+// Point lights, assigned to view space clusters on the CPU (see LightClusters), keep the sizes in step
+const int ClusterTilesX = 16;
+const int ClusterTilesY = 9;
+const int ClusterSlices = 24;
+uniform samplerBuffer lightData;  // two texels per light, world position and radius, colour times intensity
+uniform usamplerBuffer lightGrid; // offset and count per cluster, the light indices they point at after that
+
+// Only the lights whose range reaches this fragment's cluster are looked at
+vec3 pointLighting(vec3 norm, vec3 baseColor) {
+    if (clusters.z <= 0.0) return vec3(0.0);
+
+    vec2 ndc = ClipPos.xy / ClipPos.w;
+    int x = clamp(int((ndc.x * 0.5 + 0.5) * float(ClusterTilesX)), 0, ClusterTilesX - 1);
+    int y = clamp(int((ndc.y * 0.5 + 0.5) * float(ClusterTilesY)), 0, ClusterTilesY - 1);
+    int slice = clamp(int(floor(log(max(ClipPos.w, 1e-4)) * clusters.x + clusters.y)), 0, ClusterSlices - 1);
+    int cluster = (slice * ClusterTilesY + y) * ClusterTilesX + x;
+
+    int offset = int(texelFetch(lightGrid, cluster * 2).r);
+    int count = int(texelFetch(lightGrid, cluster * 2 + 1).r);
+
+    vec3 result = vec3(0.0);
+    for (int i = 0; i < count; ++i) {
+        int light = int(texelFetch(lightGrid, offset + i).r);
+        vec4 positionRadius = texelFetch(lightData, light * 2);
+        vec3 color = texelFetch(lightData, light * 2 + 1).rgb;
+
+        vec3 toLight = positionRadius.xyz - FragPos;
+        float distance2 = dot(toLight, toLight);
+        float range2 = positionRadius.w * positionRadius.w;
+        if (distance2 >= range2) continue;
+
+        // Smooth falloff that reaches zero at the radius, so the cluster bounds are exact
+        float falloff = 1.0 - distance2 / range2;
+        float diff = max(dot(norm, toLight * inversesqrt(max(distance2, 1e-8))), 0.0);
+        result += color * diff * falloff * falloff * baseColor;
+    }
+    return result;
+}
 
 void main() {
     if (isPreview) {
         // Preview rendering - simple lighting with highlight color
         vec3 norm = normalize(Normal);
-        vec3 lightDir = normalize(lightPos - FragPos);
+        vec3 lightDir = normalize(lightPos.xyz - FragPos);
         float diff = max(dot(norm, lightDir), 0.0);
 
         // Use preview color with basic lighting
@@ -35,17 +82,18 @@ void main() {
         FragColor = vec4(color, previewAlpha);
     } else {
         // Normal rendering - full material and texture
-        vec3 baseColor = hasDiffuseMap ? texture(diffuseMap, TexCoords).rgb : material.diffuse;
+        vec3 baseColor = hasDiffuseMap ? texture(diffuseMap, TexCoords).rgb : material.diffuse.rgb;
+        baseColor *= Tint.rgb;
 
         // Calculate lighting
         vec3 norm = normalize(Normal);
-        vec3 lightDir = normalize(lightPos - FragPos);
+        vec3 lightDir = normalize(lightPos.xyz - FragPos);
         float diff = max(dot(norm, lightDir), 0.0);
 
         // Combine lighting
-        vec3 ambient = lightColor * material.ambient * baseColor;
-        vec3 diffuse = lightColor * diff * baseColor;
+        vec3 ambient = lightColor.rgb * material.ambient.rgb * baseColor;
+        vec3 diffuse = lightColor.rgb * diff * baseColor;
 
-        FragColor = vec4(ambient + diffuse, 1.0);
+        FragColor = vec4(ambient + diffuse + pointLighting(norm, baseColor), 1.0);
     }
 }
\ No newline at end of file
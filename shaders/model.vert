@@ -3,20 +3,65 @@ layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
 
+// Per instance, only read when instanced (see InstanceBatch)
+layout (location = 3) in mat4 aInstanceModel;
+layout (location = 7) in vec4 aInstanceTint;
+layout (location = 8) in mat3 aInstanceNormal;
+
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoords;
+out vec4 Tint;
+out vec4 ClipPos;  // for the fragment's light cluster, w is the view depth
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+uniform mat3 normalMatrix;  // inverse transpose of model's 3x3, worked out on the CPU
+uniform bool instanced;
+uniform bool bakedTint;  // static batches send a per vertex tint in aInstanceTint (see StaticBatch)
+
+// Shared by every program, filled once per frame (see FrameBlock in uniformblocks.h)
+layout (std140) uniform Frame {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPos;
+    vec4 lightPos;
+    vec4 lightColor;
+    float time;
+    vec4 clusters;  // point light slices: x log depth scale, y bias, z light count
+};
+
+// Compact meshes send unorm16 positions inside the mesh bounds and octahedral normals in aNormal.xy
+uniform bool compactVertices;
+uniform vec3 positionOffset;
+uniform vec3 positionScale;
+
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) {
+        vec2 signNotZero = vec2(e.x >= 0.0 ? 1.0 : -1.0, e.y >= 0.0 ? 1.0 : -1.0);
+        n.xy = (1.0 - abs(n.yx)) * signNotZero;
+    }
+    return normalize(n);
+}
 
 void main() {
     TexCoords = aTexCoords;
 
+    vec3 position = aPos;
+    vec3 normal = aNormal;
+    if (compactVertices) {
+        position = positionOffset + aPos * positionScale;
+        normal = octDecode(aNormal.xy);
+    }
+
+    mat4 modelMatrix = instanced ? aInstanceModel : model;
+    mat3 normalTransform = instanced ? aInstanceNormal : normalMatrix;
+    Tint = (instanced || bakedTint) ? aInstanceTint : vec4(1.0);
+
     // Transform vertex position and normal
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    FragPos = vec3(modelMatrix * vec4(position, 1.0));
+    Normal = normalTransform * normal;
 
     gl_Position = projection * view * vec4(FragPos, 1.0);
-}
\ No newline at end of file
+    ClipPos = gl_Position;
+}
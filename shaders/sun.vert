@@ -3,8 +3,17 @@ layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+
+// Shared by every program, filled once per frame (see FrameBlock in uniformblocks.h)
+layout (std140) uniform Frame {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPos;
+    vec4 lightPos;
+    vec4 lightColor;
+    float time;
+    vec4 clusters;  // point light slices: x log depth scale, y bias, z light count
+};
 
 out vec3 Normal;
 out vec3 FragPos;
@@ -14,7 +23,8 @@ void main() {
     gl_Position = projection * view * model * vec4(aPos, 1.0);
 
     // Pass normal and fragment position to fragment shader
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    // Only ever translated, so the model's 3x3 is already the normal matrix
+    Normal = mat3(model) * aNormal;
     FragPos = vec3(model * vec4(aPos, 1.0));
 
 }
\ No newline at end of file
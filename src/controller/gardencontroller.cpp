@@ -18,6 +18,8 @@ GardenController::GardenController(std::unique_ptr<GardenModel> model, QObject*
             this, &GardenController::temperatureChanged);
     connect(m_model.get(), &GardenModel::moistureChanged,
             this, &GardenController::moistureChanged);
+    connect(m_model.get(), &GardenModel::lightsChanged,
+            this, &GardenController::lightsChanged);
     connect(m_model.get(), &GardenModel::gardenLoaded,
             this, &GardenController::gardenLoaded);
     connect(m_model.get(), &GardenModel::gardenSaved,
@@ -40,6 +40,7 @@ signals:
     void plantRemoved(const QPoint& position);
     void temperatureChanged(float temperature);
     void moistureChanged(float moisture);
+    void lightsChanged();
     void gardenLoaded();
     void gardenSaved();
 
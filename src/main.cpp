@@ -14,6 +14,9 @@ int main(int argc, char *argv[]) {
 
     format.setSamples(4);
 
+    // Swaps wait for vsync, the widget only asks for frames when something changed
+    format.setSwapInterval(1);
+
     QSurfaceFormat::setDefaultFormat(format);
 
     MainWindow mainWindow;
@@ -0,0 +1,229 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include "bakedmesh.h"
+#include <QByteArray>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <cstring>
+
+static_assert(sizeof(Vertex) == 32, "baked meshes store Vertex as raw bytes");
+static_assert(sizeof(CompactVertex) == 16, "baked meshes store CompactVertex as raw bytes");
+static_assert(sizeof(BakedMeshHeader) == 128, "header layout is part of the file format");
+
+namespace {
+
+constexpr quint64 DataAlignment = 16;
+
+quint64 alignUp(quint64 value) {
+    return (value + DataAlignment - 1) & ~(DataAlignment - 1);
+}
+
+void appendFloats(QByteArray &block, const float *values, int count) {
+    block.append(reinterpret_cast<const char*>(values), qsizetype(count * sizeof(float)));
+}
+
+void appendString(QByteArray &block, const QString &value) {
+    QByteArray utf8 = value.toUtf8();
+    quint32 length = quint32(utf8.size());
+    block.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    block.append(utf8);
+}
+
+// Asset paths are stored relative to the .gmesh so a moved or copied tree still finds them
+QString toStored(const QDir &dir, const QString &path) {
+    return path.isEmpty() ? path : dir.relativeFilePath(path);
+}
+
+QString fromStored(const QDir &dir, const QString &path) {
+    return path.isEmpty() ? path : QDir::cleanPath(dir.absoluteFilePath(path));
+}
+
+// Bounds checked reader over the material block
+struct BlockReader {
+    const char *p;
+    const char *end;
+
+    bool readFloats(float *values, int count) {
+        size_t bytes = size_t(count) * sizeof(float);
+        if (size_t(end - p) < bytes) return false;
+        std::memcpy(values, p, bytes);
+        p += bytes;
+        return true;
+    }
+
+    bool readString(QString &value) {
+        quint32 length;
+        if (size_t(end - p) < sizeof(length)) return false;
+        std::memcpy(&length, p, sizeof(length));
+        p += sizeof(length);
+        if (size_t(end - p) < length) return false;
+        value = QString::fromUtf8(p, qsizetype(length));
+        p += length;
+        return true;
+    }
+};
+
+}
+
+QString BakedMesh::bakedPathFor(const QString &objPath) {
+    QFileInfo info(objPath);
+    return info.path() + "/" + info.completeBaseName() + ".gmesh";
+}
+
+quint32 BakedMesh::strideFor(VertexFormat format) {
+    return format == VertexFormat::Compact ? sizeof(CompactVertex) : sizeof(Vertex);
+}
+
+bool BakedMesh::write(const QString &bakedPath, const QString &objPath, const MeshData &mesh,
+                      const std::vector<CompactVertex> *compact) {
+    VertexFormat format = compact ? VertexFormat::Compact : VertexFormat::Full;
+    const void *vertexData = compact ? static_cast<const void*>(compact->data()) : mesh.vertices.data();
+
+    BakedMeshHeader header{};
+    std::memcpy(header.magic, Magic, sizeof(header.magic));
+    header.version = Version;
+    header.vertexCount = quint32(mesh.vertices.size());
+    header.indexCount = quint32(mesh.indices.size());
+    header.vertexStride = strideFor(format);
+    header.vertexFormat = quint32(format);
+    for (int i = 0; i < 3; ++i) {
+        header.boundsMin[i] = mesh.boundsMin[i];
+        header.boundsMax[i] = mesh.boundsMax[i];
+    }
+
+    if (!SourceStamp::make(objPath, header.obj)) return false;
+    if (mesh.mtlPath.isEmpty() || !SourceStamp::make(mesh.mtlPath, header.mtl)) {
+        header.mtl = SourceStamp{};
+    }
+
+    QByteArray material;
+    const Material &m = mesh.material;
+    float values[11] = {
+            m.ambient.x(), m.ambient.y(), m.ambient.z(),
+            m.diffuse.x(), m.diffuse.y(), m.diffuse.z(),
+            m.specular.x(), m.specular.y(), m.specular.z(),
+            m.shininess, m.bumpMultiplier
+    };
+    QDir bakedDir = QFileInfo(bakedPath).absoluteDir();
+    appendFloats(material, values, 11);
+    appendString(material, toStored(bakedDir, m.diffuseMap));
+    appendString(material, toStored(bakedDir, m.normalMap));
+    appendString(material, toStored(bakedDir, mesh.mtlPath));
+
+    header.vertexOffset = alignUp(sizeof(BakedMeshHeader));
+    header.indexOffset = alignUp(header.vertexOffset + quint64(header.vertexCount) * header.vertexStride);
+    header.materialOffset = alignUp(header.indexOffset + quint64(mesh.indices.size()) * sizeof(unsigned int));
+    header.materialSize = quint64(material.size());
+
+    QSaveFile file(bakedPath);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    auto writeAt = [&file](quint64 offset, const void *data, quint64 size) {
+        // Zero pad up to the aligned offset
+        QByteArray padding(qsizetype(offset - quint64(file.pos())), '\0');
+        return file.write(padding) == padding.size() &&
+               file.write(static_cast<const char*>(data), qint64(size)) == qint64(size);
+    };
+
+    bool ok = file.write(reinterpret_cast<const char*>(&header), sizeof(header)) == sizeof(header)
+              && writeAt(header.vertexOffset, vertexData, quint64(header.vertexCount) * header.vertexStride)
+              && writeAt(header.indexOffset, mesh.indices.data(), mesh.indices.size() * sizeof(unsigned int))
+              && writeAt(header.materialOffset, material.constData(), header.materialSize);
+
+    return ok && file.commit();
+}
+
+bool BakedMesh::fail(const QString &message) {
+    m_error = message;
+    m_header = nullptr;
+    m_file.close();
+    return false;
+}
+
+bool BakedMesh::open(const QString &bakedPath) {
+    m_error.clear();
+    m_header = nullptr;
+    if (!m_file.open(bakedPath)) {
+        return fail("no baked mesh at " + bakedPath);
+    }
+
+    quint64 fileSize = quint64(m_file.size());
+    if (fileSize < sizeof(BakedMeshHeader)) {
+        return fail("truncated header in " + bakedPath);
+    }
+
+    const auto *header = reinterpret_cast<const BakedMeshHeader*>(m_file.data());
+    if (std::memcmp(header->magic, Magic, sizeof(header->magic)) != 0 ||
+        header->version != Version || header->vertexFormat > quint32(VertexFormat::Compact) ||
+        header->vertexStride != strideFor(VertexFormat(header->vertexFormat))) {
+        return fail("incompatible baked mesh " + bakedPath);
+    }
+
+    // Make sure every section is inside the file before anything reads it
+    quint64 vertexEnd = header->vertexOffset + quint64(header->vertexCount) * header->vertexStride;
+    quint64 indexEnd = header->indexOffset + quint64(header->indexCount) * sizeof(unsigned int);
+    quint64 materialEnd = header->materialOffset + header->materialSize;
+    if (vertexEnd > fileSize || indexEnd > fileSize || materialEnd > fileSize ||
+        header->vertexOffset % alignof(Vertex) != 0 || header->indexOffset % alignof(unsigned int) != 0) {
+        return fail("corrupt section table in " + bakedPath);
+    }
+
+    m_header = header;
+    m_directory = QFileInfo(bakedPath).absolutePath();
+    return true;
+}
+
+bool BakedMesh::isUpToDate(const QString &objPath) const {
+    if (!m_header) return false;
+    if (!SourceStamp::matches(objPath, m_header->obj)) return false;
+
+    MeshData info;
+    readMeshInfo(info);
+    if (info.mtlPath.isEmpty()) return true;
+
+    // OBJ is here but the MTL it was baked with isn't, don't trust the baked material
+    if (QFileInfo::exists(objPath) && !QFileInfo::exists(info.mtlPath)) return false;
+    if (!SourceStamp::matches(info.mtlPath, m_header->mtl)) return false;
+    return true;
+}
+
+const Vertex* BakedMesh::vertices() const {
+    return reinterpret_cast<const Vertex*>(m_file.data() + m_header->vertexOffset);
+}
+
+const CompactVertex* BakedMesh::compactVertices() const {
+    return reinterpret_cast<const CompactVertex*>(m_file.data() + m_header->vertexOffset);
+}
+
+const unsigned int* BakedMesh::indices() const {
+    return reinterpret_cast<const unsigned int*>(m_file.data() + m_header->indexOffset);
+}
+
+void BakedMesh::readMeshInfo(MeshData &mesh) const {
+    mesh.boundsMin = QVector3D(m_header->boundsMin[0], m_header->boundsMin[1], m_header->boundsMin[2]);
+    mesh.boundsMax = QVector3D(m_header->boundsMax[0], m_header->boundsMax[1], m_header->boundsMax[2]);
+
+    const char *block = reinterpret_cast<const char*>(m_file.data() + m_header->materialOffset);
+    BlockReader reader{block, block + m_header->materialSize};
+
+    float values[11];
+    Material material;
+    if (reader.readFloats(values, 11)) {
+        material.ambient = QVector3D(values[0], values[1], values[2]);
+        material.diffuse = QVector3D(values[3], values[4], values[5]);
+        material.specular = QVector3D(values[6], values[7], values[8]);
+        material.shininess = values[9];
+        material.bumpMultiplier = values[10];
+        if (reader.readString(material.diffuseMap) && reader.readString(material.normalMap)) {
+            reader.readString(mesh.mtlPath);
+        }
+    }
+    QDir bakedDir(m_directory);
+    material.diffuseMap = fromStored(bakedDir, material.diffuseMap);
+    material.normalMap = fromStored(bakedDir, material.normalMap);
+    mesh.mtlPath = fromStored(bakedDir, mesh.mtlPath);
+    mesh.material = material;
+}
@@ -0,0 +1,80 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_BAKEDMESH_H
+#define GARDEN_SIMULATION_BAKEDMESH_H
+
+#pragma once
+#include <QString>
+#include <vector>
+#include "model/compactvertex.h"
+#include "model/mappedfile.h"
+#include "model/meshdata.h"
+#include "model/sourcestamp.h"
+
+// On disk layout, native endian, all offsets from the start of the file
+// [header][vertices][indices][material block]
+struct BakedMeshHeader {
+    char magic[4];
+    quint32 version;
+    quint32 vertexCount;
+    quint32 indexCount;
+    quint32 vertexStride;
+    quint32 vertexFormat;  // VertexFormat, picks Vertex or CompactVertex
+    float boundsMin[3];
+    float boundsMax[3];
+    quint64 vertexOffset;
+    quint64 indexOffset;
+    quint64 materialOffset;
+    quint64 materialSize;
+    SourceStamp obj;
+    SourceStamp mtl;
+};
+
+// Binary mesh container written by garden_bake and read back with a memory map, so
+// the vertex/index arrays can go to glBufferData without being copied or parsed
+class BakedMesh {
+
+public:
+    static constexpr char Magic[4] = {'G', 'M', 'S', 'H'};
+    static constexpr quint32 Version = 5;
+
+    // Where the baked file for an OBJ lives, tomato.obj -> tomato.gmesh
+    static QString bakedPathFor(const QString &objPath);
+
+    // compact replaces mesh.vertices when given, it has to be quantized against mesh's bounds
+    static bool write(const QString &bakedPath, const QString &objPath, const MeshData &mesh,
+                      const std::vector<CompactVertex> *compact = nullptr);
+
+    bool open(const QString &bakedPath);
+
+    // True if the OBJ (and its MTL) still match what was baked
+    // Timestamps are checked first, the content hash only when they differ
+    bool isUpToDate(const QString &objPath) const;
+
+    const BakedMeshHeader& header() const { return *m_header; }
+    VertexFormat vertexFormat() const { return VertexFormat(m_header->vertexFormat); }
+    const Vertex* vertices() const;
+    const CompactVertex* compactVertices() const;
+    const unsigned int* indices() const;
+    quint32 vertexCount() const { return m_header->vertexCount; }
+    quint32 indexCount() const { return m_header->indexCount; }
+
+    // Material, mtl path and bounds copied out of the mapping, paths resolved against the .gmesh directory
+    void readMeshInfo(MeshData &mesh) const;
+
+    const QString& getError() const { return m_error; }
+
+private:
+    MappedFile m_file;
+    const BakedMeshHeader* m_header = nullptr;
+    QString m_directory;
+    QString m_error;
+
+    bool fail(const QString &message);
+    static quint32 strideFor(VertexFormat format);
+};
+
+
+#endif //GARDEN_SIMULATION_BAKEDMESH_H
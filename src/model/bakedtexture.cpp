@@ -0,0 +1,185 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include "bakedtexture.h"
+#include "model/filehash.h"
+#include "model/parallel.h"
+#include <QByteArray>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <algorithm>
+#include <cstring>
+
+static_assert(sizeof(BakedTextureHeader) == 176, "header layout is part of the file format");
+
+namespace {
+
+constexpr quint64 DataAlignment = 16;
+
+quint64 alignUp(quint64 value) {
+    return (value + DataAlignment - 1) & ~(DataAlignment - 1);
+}
+
+quint64 levelSize(TextureFormat format, quint32 width, quint32 height, int level) {
+    int w = int(std::max(1u, width >> level));
+    int h = int(std::max(1u, height >> level));
+    return quint64(BlockCompressor::levelSize(format, w, h));
+}
+
+// Halves src with a 2x2 box filter, odd edges reuse their last row/column
+QImage downsample(const QImage &src) {
+    int srcWidth = src.width();
+    int srcHeight = src.height();
+    int width = std::max(1, srcWidth / 2);
+    int height = std::max(1, srcHeight / 2);
+    QImage dst(width, height, QImage::Format_RGBA8888);
+
+    // Rows split over threads, small levels aren't worth a thread
+    parallelFor(height, 64, [&](int firstRow, int endRow) {
+        for (int y = firstRow; y < endRow; ++y) {
+            const uchar *row0 = src.constScanLine(std::min(2 * y, srcHeight - 1));
+            const uchar *row1 = src.constScanLine(std::min(2 * y + 1, srcHeight - 1));
+            uchar *out = dst.scanLine(y);
+
+            for (int x = 0; x < width; ++x) {
+                int x0 = std::min(2 * x, srcWidth - 1) * 4;
+                int x1 = std::min(2 * x + 1, srcWidth - 1) * 4;
+                for (int c = 0; c < 4; ++c) {
+                    out[x * 4 + c] = uchar((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2);
+                }
+            }
+        }
+    });
+    return dst;
+}
+
+}
+
+QString BakedTexture::cachePathFor(const QString &sourcePath) {
+    QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (cacheDir.isEmpty()) return QString();
+
+    // Keyed by the absolute path, the source stamp inside decides whether it's still valid
+    QByteArray key = QFileInfo(sourcePath).absoluteFilePath().toUtf8();
+    quint64 hash = fnv1a64(std::string_view(key.constData(), size_t(key.size())));
+    return cacheDir + "/textures/" + QString::number(hash, 16).rightJustified(16, '0') + ".gtex";
+}
+
+QString BakedTexture::bakedPathFor(const QString &sourcePath) {
+    QFileInfo info(sourcePath);
+    return info.path() + "/" + info.completeBaseName() + ".gtex";
+}
+
+bool BakedTexture::isEnabled() {
+    return !qEnvironmentVariableIsSet("GARDEN_NO_TEXTURE_CACHE");
+}
+
+QImage BakedTexture::prepareLevel0(const QImage &source) {
+    // OpenGL needs textures flipped vertically
+    return source.convertToFormat(QImage::Format_RGBA8888).mirrored();
+}
+
+std::vector<QImage> BakedTexture::buildMipChain(const QImage &level0) {
+    std::vector<QImage> levels;
+    levels.push_back(level0);
+    while (int(levels.size()) < MaxLevels &&
+           (levels.back().width() > 1 || levels.back().height() > 1)) {
+        levels.push_back(downsample(levels.back()));
+    }
+    return levels;
+}
+
+bool BakedTexture::write(const QString &path, const QString &sourcePath, const std::vector<QImage> &levels,
+                         TextureFormat format) {
+    if (path.isEmpty() || levels.empty() || int(levels.size()) > MaxLevels) return false;
+
+    BakedTextureHeader header{};
+    std::memcpy(header.magic, Magic, sizeof(header.magic));
+    header.version = Version;
+    header.width = quint32(levels[0].width());
+    header.height = quint32(levels[0].height());
+    header.levelCount = quint32(levels.size());
+    header.format = quint32(format);
+    if (!SourceStamp::make(sourcePath, header.source)) return false;
+
+    std::vector<std::vector<uchar>> encoded(levels.size());
+    quint64 offset = alignUp(sizeof(BakedTextureHeader));
+    for (size_t i = 0; i < levels.size(); ++i) {
+        const QImage &level = levels[i];
+        if (quint64(level.sizeInBytes()) != levelSize(TextureFormat::RGBA8, header.width, header.height, int(i))) {
+            return false;
+        }
+        BlockCompressor::encode(format, level.constBits(), level.width(), level.height(), encoded[i]);
+        header.levelOffsets[i] = offset;
+        offset = alignUp(offset + quint64(encoded[i].size()));
+    }
+
+    QDir().mkpath(QFileInfo(path).path());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    bool ok = file.write(reinterpret_cast<const char*>(&header), sizeof(header)) == sizeof(header);
+    for (size_t i = 0; ok && i < levels.size(); ++i) {
+        // Zero pad up to the aligned offset
+        QByteArray padding(qsizetype(header.levelOffsets[i] - quint64(file.pos())), '\0');
+        qint64 size = qint64(encoded[i].size());
+        ok = file.write(padding) == padding.size() &&
+             file.write(reinterpret_cast<const char*>(encoded[i].data()), size) == size;
+    }
+
+    return ok && file.commit();
+}
+
+bool BakedTexture::fail(const QString &message) {
+    m_error = message;
+    m_header = nullptr;
+    m_file.close();
+    return false;
+}
+
+bool BakedTexture::open(const QString &path) {
+    m_error.clear();
+    m_header = nullptr;
+    if (path.isEmpty() || !m_file.open(path)) {
+        return fail("no baked texture at " + path);
+    }
+
+    quint64 fileSize = quint64(m_file.size());
+    if (fileSize < sizeof(BakedTextureHeader)) {
+        return fail("truncated header in " + path);
+    }
+
+    const auto *header = reinterpret_cast<const BakedTextureHeader*>(m_file.data());
+    if (std::memcmp(header->magic, Magic, sizeof(header->magic)) != 0 || header->version != Version ||
+        header->width == 0 || header->height == 0 || header->format > quint32(TextureFormat::BC5) ||
+        header->levelCount == 0 || header->levelCount > quint32(MaxLevels)) {
+        return fail("incompatible baked texture " + path);
+    }
+
+    // Make sure every level is inside the file before anything reads it
+    auto format = TextureFormat(header->format);
+    for (quint32 i = 0; i < header->levelCount; ++i) {
+        if (header->levelOffsets[i] + levelSize(format, header->width, header->height, int(i)) > fileSize) {
+            return fail("corrupt level table in " + path);
+        }
+    }
+
+    m_header = header;
+    return true;
+}
+
+bool BakedTexture::isUpToDate(const QString &sourcePath) const {
+    return m_header && SourceStamp::matches(sourcePath, m_header->source);
+}
+
+MipLevel BakedTexture::level(int index) const {
+    MipLevel level;
+    level.width = std::max(1, int(m_header->width >> index));
+    level.height = std::max(1, int(m_header->height >> index));
+    level.pixels = m_file.data() + m_header->levelOffsets[index];
+    level.size = size_t(levelSize(format(), m_header->width, m_header->height, index));
+    return level;
+}
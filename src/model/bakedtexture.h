@@ -0,0 +1,88 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_BAKEDTEXTURE_H
+#define GARDEN_SIMULATION_BAKEDTEXTURE_H
+
+#pragma once
+#include <QImage>
+#include <QString>
+#include <vector>
+#include "model/blockcompressor.h"
+#include "model/mappedfile.h"
+#include "model/sourcestamp.h"
+
+// One level of a mip chain, points into either a QImage or a mapped cache file
+struct MipLevel {
+    int width;
+    int height;
+    const uchar *pixels;  // tightly packed RGBA8888 or compressed blocks, bottom row first
+    size_t size;
+};
+
+// On disk layout, native endian, all offsets from the start of the file
+// [header][level 0][level 1]...[level n-1]
+struct BakedTextureHeader {
+    char magic[4];
+    quint32 version;
+    quint32 width;
+    quint32 height;
+    quint32 levelCount;
+    quint32 format;  // TextureFormat
+    SourceStamp source;
+    quint64 levelOffsets[16];
+};
+
+// Flipped pixels and a full mip chain built on the CPU, so a texture loads with a memory map
+// instead of a PNG decode and glGenerateMipmap. Used two ways:
+//  - the runtime decoded texture cache, RGBA8 files in the user's cache directory keyed by path
+//  - block compressed textures from garden_bake, written next to the source image
+class BakedTexture {
+
+public:
+    static constexpr char Magic[4] = {'G', 'T', 'E', 'X'};
+    static constexpr quint32 Version = 2;
+    static constexpr int MaxLevels = 16;
+
+    // Where the cache file for an image lives, empty if there's no writable cache directory
+    static QString cachePathFor(const QString &sourcePath);
+
+    // Where garden_bake puts the compressed copy of an image, Plants_Normal.png -> Plants_Normal.gtex
+    static QString bakedPathFor(const QString &sourcePath);
+
+    // False when GARDEN_NO_TEXTURE_CACHE is set, handy for timing startup without it
+    static bool isEnabled();
+
+    // Converts a decoded image to the layout every level is stored in, RGBA8888 flipped for GL
+    static QImage prepareLevel0(const QImage &source);
+
+    // Builds the rest of the chain from level 0 (RGBA8888) with a 2x2 box filter,
+    // rows are split over threads for the big levels
+    static std::vector<QImage> buildMipChain(const QImage &level0);
+
+    // levels are RGBA8888, anything but RGBA8 gets block compressed on the way out
+    static bool write(const QString &path, const QString &sourcePath, const std::vector<QImage> &levels,
+                      TextureFormat format = TextureFormat::RGBA8);
+
+    bool open(const QString &path);
+
+    // True if the source image still matches what was cached
+    bool isUpToDate(const QString &sourcePath) const;
+
+    TextureFormat format() const { return TextureFormat(m_header->format); }
+    int levelCount() const { return int(m_header->levelCount); }
+    MipLevel level(int index) const;
+
+    const QString& getError() const { return m_error; }
+
+private:
+    MappedFile m_file;
+    const BakedTextureHeader* m_header = nullptr;
+    QString m_error;
+
+    bool fail(const QString &message);
+};
+
+
+#endif //GARDEN_SIMULATION_BAKEDTEXTURE_H
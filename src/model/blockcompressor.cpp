@@ -0,0 +1,336 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include "blockcompressor.h"
+#include "model/parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+struct Color {
+    float r, g, b;
+};
+
+quint16 packRgb565(const Color &c) {
+    auto quantize = [](float v, int max) {
+        return int(std::lround(std::clamp(v, 0.0f, 255.0f) * max / 255.0f));
+    };
+    return quint16((quantize(c.r, 31) << 11) | (quantize(c.g, 63) << 5) | quantize(c.b, 31));
+}
+
+// Same bit replication the hardware does
+Color unpackRgb565(quint16 packed) {
+    int r = (packed >> 11) & 31;
+    int g = (packed >> 5) & 63;
+    int b = packed & 31;
+    return Color{float((r << 3) | (r >> 2)), float((g << 2) | (g >> 4)), float((b << 3) | (b >> 2))};
+}
+
+float distanceSquared(const Color &a, const uchar *texel) {
+    float dr = a.r - texel[0];
+    float dg = a.g - texel[1];
+    float db = a.b - texel[2];
+    return dr * dr + dg * dg + db * db;
+}
+
+// Picks the closest of the 4 colour mode palette entries for every texel, returns the total error
+// c0 and c1 are swapped if needed, 4 colour mode needs c0 > c1
+float fitIndices(const uchar texels[16][4], quint16 &c0, quint16 &c1, quint32 &indices) {
+    if (c0 < c1) std::swap(c0, c1);
+
+    Color p0 = unpackRgb565(c0);
+    Color p1 = unpackRgb565(c1);
+    Color palette[4] = {
+            p0, p1,
+            {(2 * p0.r + p1.r) / 3, (2 * p0.g + p1.g) / 3, (2 * p0.b + p1.b) / 3},
+            {(p0.r + 2 * p1.r) / 3, (p0.g + 2 * p1.g) / 3, (p0.b + 2 * p1.b) / 3},
+    };
+    int entries = c0 == c1 ? 1 : 4;  // equal endpoints mean 3 colour mode, index 0 is the safe pick
+
+    indices = 0;
+    float error = 0.0f;
+    for (int i = 0; i < 16; ++i) {
+        int best = 0;
+        float bestDistance = distanceSquared(palette[0], texels[i]);
+        for (int p = 1; p < entries; ++p) {
+            float d = distanceSquared(palette[p], texels[i]);
+            if (d < bestDistance) {
+                bestDistance = d;
+                best = p;
+            }
+        }
+        indices |= quint32(best) << (2 * i);
+        error += bestDistance;
+    }
+    return error;
+}
+
+// Endpoints minimizing the squared error for a fixed set of indices
+bool leastSquaresEndpoints(const uchar texels[16][4], quint32 indices, Color &e0, Color &e1) {
+    static const float weights[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+
+    float aa = 0, ab = 0, bb = 0;
+    float ax[3] = {0, 0, 0};
+    float bx[3] = {0, 0, 0};
+    for (int i = 0; i < 16; ++i) {
+        float alpha = weights[(indices >> (2 * i)) & 3];
+        float beta = 1.0f - alpha;
+        aa += alpha * alpha;
+        ab += alpha * beta;
+        bb += beta * beta;
+        for (int c = 0; c < 3; ++c) {
+            ax[c] += alpha * texels[i][c];
+            bx[c] += beta * texels[i][c];
+        }
+    }
+
+    float det = aa * bb - ab * ab;
+    if (std::abs(det) < 1e-6f) return false;
+
+    float solved0[3];
+    float solved1[3];
+    for (int c = 0; c < 3; ++c) {
+        solved0[c] = (ax[c] * bb - bx[c] * ab) / det;
+        solved1[c] = (bx[c] * aa - ax[c] * ab) / det;
+    }
+    e0 = Color{solved0[0], solved0[1], solved0[2]};
+    e1 = Color{solved1[0], solved1[1], solved1[2]};
+    return true;
+}
+
+void writeBC1(uchar *block, quint16 c0, quint16 c1, quint32 indices) {
+    block[0] = uchar(c0 & 0xff);
+    block[1] = uchar(c0 >> 8);
+    block[2] = uchar(c1 & 0xff);
+    block[3] = uchar(c1 >> 8);
+    for (int i = 0; i < 4; ++i) {
+        block[4 + i] = uchar(indices >> (8 * i));
+    }
+}
+
+// 4x4 texels starting at (x, y), edges repeated for partial blocks
+void gatherBlock(const uchar *rgba, int width, int height, int x, int y, uchar texels[16][4]) {
+    for (int row = 0; row < 4; ++row) {
+        int sy = std::min(y + row, height - 1);
+        for (int col = 0; col < 4; ++col) {
+            int sx = std::min(x + col, width - 1);
+            std::memcpy(texels[row * 4 + col], rgba + (size_t(sy) * width + sx) * 4, 4);
+        }
+    }
+}
+
+}
+
+size_t BlockCompressor::levelSize(TextureFormat format, int width, int height) {
+    size_t blocks = size_t((width + 3) / 4) * size_t((height + 3) / 4);
+    switch (format) {
+        case TextureFormat::RGBA8:
+            return size_t(width) * size_t(height) * 4;
+        case TextureFormat::BC1:
+            return blocks * 8;
+        case TextureFormat::BC3:
+        case TextureFormat::BC5:
+            return blocks * 16;
+    }
+    return 0;
+}
+
+void BlockCompressor::encode(TextureFormat format, const uchar *rgba, int width, int height, std::vector<uchar> &out) {
+    out.resize(levelSize(format, width, height));
+    if (format == TextureFormat::RGBA8) {
+        std::memcpy(out.data(), rgba, out.size());
+        return;
+    }
+
+    int blocksX = (width + 3) / 4;
+    int blocksY = (height + 3) / 4;
+    size_t blockSize = format == TextureFormat::BC1 ? 8 : 16;
+
+    // Block rows are independent, 16 rows is 64 image rows per thread at minimum
+    parallelFor(blocksY, 16, [&](int firstRow, int endRow) {
+        uchar texels[16][4];
+        for (int by = firstRow; by < endRow; ++by) {
+            for (int bx = 0; bx < blocksX; ++bx) {
+                gatherBlock(rgba, width, height, bx * 4, by * 4, texels);
+                uchar *block = out.data() + (size_t(by) * blocksX + bx) * blockSize;
+
+                switch (format) {
+                    case TextureFormat::BC1:
+                        encodeBC1Block(texels, block);
+                        break;
+                    case TextureFormat::BC3:
+                        encodeBC4Block(texels, 3, block);
+                        encodeBC1Block(texels, block + 8);
+                        break;
+                    case TextureFormat::BC5:
+                        encodeBC4Block(texels, 0, block);
+                        encodeBC4Block(texels, 1, block + 8);
+                        break;
+                    case TextureFormat::RGBA8:
+                        break;
+                }
+            }
+        }
+    });
+}
+
+void BlockCompressor::encodeBC1Block(const uchar texels[16][4], uchar *block) {
+    // Mean and covariance of the block's colours
+    float mean[3] = {0, 0, 0};
+    for (int i = 0; i < 16; ++i) {
+        for (int c = 0; c < 3; ++c) mean[c] += texels[i][c];
+    }
+    for (float &m : mean) m /= 16.0f;
+
+    float cov[6] = {0, 0, 0, 0, 0, 0};  // rr rg rb gg gb bb
+    for (int i = 0; i < 16; ++i) {
+        float r = texels[i][0] - mean[0];
+        float g = texels[i][1] - mean[1];
+        float b = texels[i][2] - mean[2];
+        cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+        cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+    }
+
+    // Principal axis by power iteration, a few steps is plenty for a 3x3
+    float axis[3] = {1.0f, 1.0f, 1.0f};
+    for (int iteration = 0; iteration < 8; ++iteration) {
+        float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+        float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+        float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+        float length = std::max({std::abs(x), std::abs(y), std::abs(z)});
+        if (length < 1e-6f) break;  // flat block, any axis works
+        axis[0] = x / length;
+        axis[1] = y / length;
+        axis[2] = z / length;
+    }
+    float axisLength = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+    for (float &a : axis) a /= axisLength;
+
+    // Extent of the block along the axis
+    float minT = 0.0f;
+    float maxT = 0.0f;
+    for (int i = 0; i < 16; ++i) {
+        float t = (texels[i][0] - mean[0]) * axis[0] + (texels[i][1] - mean[1]) * axis[1] +
+                  (texels[i][2] - mean[2]) * axis[2];
+        minT = std::min(minT, t);
+        maxT = std::max(maxT, t);
+    }
+
+    // Pull the ends in a little, the outermost texels rarely sit exactly on the endpoints
+    float inset = (maxT - minT) / 16.0f;
+    maxT -= inset;
+    minT += inset;
+    Color e0{mean[0] + axis[0] * maxT, mean[1] + axis[1] * maxT, mean[2] + axis[2] * maxT};
+    Color e1{mean[0] + axis[0] * minT, mean[1] + axis[1] * minT, mean[2] + axis[2] * minT};
+
+    quint16 c0 = packRgb565(e0);
+    quint16 c1 = packRgb565(e1);
+    quint32 indices;
+    float error = fitIndices(texels, c0, c1, indices);
+
+    // One refinement pass, keep it only if it actually helps
+    Color refined0, refined1;
+    if (error > 0.0f && leastSquaresEndpoints(texels, indices, refined0, refined1)) {
+        quint16 r0 = packRgb565(refined0);
+        quint16 r1 = packRgb565(refined1);
+        quint32 refinedIndices;
+        float refinedError = fitIndices(texels, r0, r1, refinedIndices);
+        if (refinedError < error) {
+            c0 = r0;
+            c1 = r1;
+            indices = refinedIndices;
+        }
+    }
+
+    writeBC1(block, c0, c1, indices);
+}
+
+void BlockCompressor::encodeBC4Block(const uchar texels[16][4], int channel, uchar *block) {
+    int lo = 255;
+    int hi = 0;
+    for (int i = 0; i < 16; ++i) {
+        lo = std::min(lo, int(texels[i][channel]));
+        hi = std::max(hi, int(texels[i][channel]));
+    }
+
+    // a0 > a1 selects the 8 value mode, 6 interpolated steps between the endpoints
+    block[0] = uchar(hi);
+    block[1] = uchar(lo);
+    std::memset(block + 2, 0, 6);
+    if (hi == lo) return;
+
+    int palette[8];
+    palette[0] = hi;
+    palette[1] = lo;
+    for (int i = 2; i < 8; ++i) {
+        palette[i] = ((8 - i) * hi + (i - 1) * lo) / 7;
+    }
+
+    quint64 bits = 0;
+    for (int i = 0; i < 16; ++i) {
+        int value = texels[i][channel];
+        int best = 0;
+        int bestDistance = std::abs(palette[0] - value);
+        for (int p = 1; p < 8; ++p) {
+            int d = std::abs(palette[p] - value);
+            if (d < bestDistance) {
+                bestDistance = d;
+                best = p;
+            }
+        }
+        bits |= quint64(best) << (3 * i);
+    }
+    for (int i = 0; i < 6; ++i) {
+        block[2 + i] = uchar(bits >> (8 * i));
+    }
+}
+
+void BlockCompressor::decodeBC1Block(const uchar *block, uchar texels[16][4]) {
+    quint16 c0 = quint16(block[0] | (block[1] << 8));
+    quint16 c1 = quint16(block[2] | (block[3] << 8));
+    quint32 indices = quint32(block[4]) | (quint32(block[5]) << 8) | (quint32(block[6]) << 16) |
+                      (quint32(block[7]) << 24);
+
+    Color p0 = unpackRgb565(c0);
+    Color p1 = unpackRgb565(c1);
+    Color palette[4] = {p0, p1, {}, {}};
+    if (c0 > c1) {
+        palette[2] = {(2 * p0.r + p1.r) / 3, (2 * p0.g + p1.g) / 3, (2 * p0.b + p1.b) / 3};
+        palette[3] = {(p0.r + 2 * p1.r) / 3, (p0.g + 2 * p1.g) / 3, (p0.b + 2 * p1.b) / 3};
+    } else {
+        palette[2] = {(p0.r + p1.r) / 2, (p0.g + p1.g) / 2, (p0.b + p1.b) / 2};
+        palette[3] = {0, 0, 0};
+    }
+
+    for (int i = 0; i < 16; ++i) {
+        const Color &c = palette[(indices >> (2 * i)) & 3];
+        texels[i][0] = uchar(c.r);
+        texels[i][1] = uchar(c.g);
+        texels[i][2] = uchar(c.b);
+        texels[i][3] = 255;
+    }
+}
+
+void BlockCompressor::decodeBC4Block(const uchar *block, int channel, uchar texels[16][4]) {
+    int a0 = block[0];
+    int a1 = block[1];
+    int palette[8] = {a0, a1};
+    if (a0 > a1) {
+        for (int i = 2; i < 8; ++i) palette[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+    } else {
+        for (int i = 2; i < 6; ++i) palette[i] = ((6 - i) * a0 + (i - 1) * a1) / 5;
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+
+    quint64 bits = 0;
+    for (int i = 0; i < 6; ++i) {
+        bits |= quint64(block[2 + i]) << (8 * i);
+    }
+    for (int i = 0; i < 16; ++i) {
+        texels[i][channel] = uchar(palette[(bits >> (3 * i)) & 7]);
+    }
+}
@@ -0,0 +1,44 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_BLOCKCOMPRESSOR_H
+#define GARDEN_SIMULATION_BLOCKCOMPRESSOR_H
+
+#pragma once
+#include <QtGlobal>
+#include <vector>
+
+// Pixel formats a baked texture level can be stored in
+enum class TextureFormat : quint32 {
+    RGBA8,  // 4 bytes per texel, what QImage decodes to
+    BC1,    // 0.5 bytes per texel, opaque colour (S3TC DXT1)
+    BC3,    // 1 byte per texel, colour plus smooth alpha (S3TC DXT5)
+    BC5     // 1 byte per texel, two channels, used for tangent space normals (RGTC2)
+};
+
+// CPU block compression encoder, no GPU needed so garden_bake runs on any build box
+// Inputs are tightly packed RGBA8888, images that aren't a multiple of 4 get their
+// edge pixels repeated into the partial blocks
+class BlockCompressor {
+
+public:
+    // Bytes for one width x height level in the given format
+    static size_t levelSize(TextureFormat format, int width, int height);
+
+    static void encode(TextureFormat format, const uchar *rgba, int width, int height, std::vector<uchar> &out);
+
+    // 16 texels in, one 8 byte block out
+    // Colour endpoints come from the principal axis of the block, refined by one least squares pass
+    static void encodeBC1Block(const uchar texels[16][4], uchar *block);
+
+    // One channel of 16 texels in, one 8 byte block out
+    static void encodeBC4Block(const uchar texels[16][4], int channel, uchar *block);
+
+    // Decoders, used by the bake tool to report the error it introduced
+    static void decodeBC1Block(const uchar *block, uchar texels[16][4]);
+    static void decodeBC4Block(const uchar *block, int channel, uchar texels[16][4]);
+};
+
+
+#endif //GARDEN_SIMULATION_BLOCKCOMPRESSOR_H
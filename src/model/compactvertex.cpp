@@ -0,0 +1,132 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include "compactvertex.h"
+#include <algorithm>
+#include <cmath>
+
+static_assert(sizeof(CompactVertex) == 16, "CompactVertex is uploaded and baked as raw bytes");
+
+namespace {
+
+constexpr float UnormMax = 65535.0f;
+constexpr float SnormMax = 32767.0f;
+constexpr float RadToDeg = 57.2957795f;
+
+float signNotZero(float v) {
+    return v < 0.0f ? -1.0f : 1.0f;
+}
+
+quint16 quantizeUnorm(float v) {
+    return quint16(std::lround(std::clamp(v, 0.0f, 1.0f) * UnormMax));
+}
+
+qint16 quantizeSnorm(float v) {
+    return qint16(std::lround(std::clamp(v, -1.0f, 1.0f) * SnormMax));
+}
+
+}
+
+void VertexQuantizer::octEncode(const QVector3D &normal, qint16 encoded[2]) {
+    // Project onto the octahedron |x| + |y| + |z| = 1, then fold the lower half over the upper
+    float l1 = std::abs(normal.x()) + std::abs(normal.y()) + std::abs(normal.z());
+    if (l1 <= 0.0f) {
+        encoded[0] = 0;
+        encoded[1] = qint16(SnormMax);  // degenerate normal, point it down z
+        return;
+    }
+
+    float x = normal.x() / l1;
+    float y = normal.y() / l1;
+    if (normal.z() < 0.0f) {
+        float foldedX = (1.0f - std::abs(y)) * signNotZero(x);
+        float foldedY = (1.0f - std::abs(x)) * signNotZero(y);
+        x = foldedX;
+        y = foldedY;
+    }
+
+    encoded[0] = quantizeSnorm(x);
+    encoded[1] = quantizeSnorm(y);
+}
+
+QVector3D VertexQuantizer::octDecode(const qint16 encoded[2]) {
+    // Mirrors octDecode in model.vert
+    float x = std::max(encoded[0] / SnormMax, -1.0f);
+    float y = std::max(encoded[1] / SnormMax, -1.0f);
+    float z = 1.0f - std::abs(x) - std::abs(y);
+    if (z < 0.0f) {
+        float unfoldedX = (1.0f - std::abs(y)) * signNotZero(x);
+        float unfoldedY = (1.0f - std::abs(x)) * signNotZero(y);
+        x = unfoldedX;
+        y = unfoldedY;
+    }
+    return QVector3D(x, y, z).normalized();
+}
+
+Vertex VertexQuantizer::dequantize(const CompactVertex &vertex, const QVector3D &boundsMin,
+                                   const QVector3D &boundsMax) {
+    QVector3D extent = boundsMax - boundsMin;
+    Vertex v;
+    for (int axis = 0; axis < 3; ++axis) {
+        v.position[axis] = boundsMin[axis] + vertex.position[axis] / UnormMax * extent[axis];
+    }
+    v.normal = octDecode(vertex.normal);
+    v.texCoords = QVector2D(float(vertex.texCoords[0]), float(vertex.texCoords[1]));
+    return v;
+}
+
+void VertexQuantizer::quantize(const MeshData &mesh, std::vector<CompactVertex> &compact,
+                               QuantizationError &error) {
+    compact.resize(mesh.vertices.size());
+    error = QuantizationError{};
+
+    // Flat axes (a ground plane) get a scale of 1 so nothing divides by zero
+    QVector3D extent = mesh.boundsMax - mesh.boundsMin;
+    QVector3D scale(extent.x() > 0.0f ? extent.x() : 1.0f,
+                    extent.y() > 0.0f ? extent.y() : 1.0f,
+                    extent.z() > 0.0f ? extent.z() : 1.0f);
+
+    float worstNormalCos = 1.0f;
+
+    for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+        const Vertex &v = mesh.vertices[i];
+        CompactVertex &c = compact[i];
+
+        for (int axis = 0; axis < 3; ++axis) {
+            float t = (v.position[axis] - mesh.boundsMin[axis]) / scale[axis];
+            c.position[axis] = quantizeUnorm(t);
+
+            float decoded = mesh.boundsMin[axis] + c.position[axis] / UnormMax * extent[axis];
+            error.position = std::max(error.position, std::abs(decoded - v.position[axis]));
+        }
+        c.position[3] = 0;
+
+        octEncode(v.normal, c.normal);
+        if (v.normal.lengthSquared() > 0.0f) {
+            float cosAngle = QVector3D::dotProduct(octDecode(c.normal), v.normal.normalized());
+            worstNormalCos = std::min(worstNormalCos, cosAngle);
+        }
+
+        for (int axis = 0; axis < 2; ++axis) {
+            c.texCoords[axis] = qfloat16(v.texCoords[axis]);
+            error.texCoord = std::max(error.texCoord, std::abs(float(c.texCoords[axis]) - v.texCoords[axis]));
+        }
+    }
+
+    error.normalDegrees = std::acos(std::clamp(worstNormalCos, -1.0f, 1.0f)) * RadToDeg;
+}
+
+bool VertexQuantizer::tryQuantize(const MeshData &mesh, std::vector<CompactVertex> &compact,
+                                  QuantizationError &error, const QuantizationTolerance &tolerance) {
+    quantize(mesh, compact, error);
+
+    // Big meshes or UVs far outside 0..1 are where this falls over, keep those at full precision
+    if (error.position > tolerance.position ||
+        error.normalDegrees > tolerance.normalDegrees ||
+        error.texCoord > tolerance.texCoord) {
+        compact.clear();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,61 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_COMPACTVERTEX_H
+#define GARDEN_SIMULATION_COMPACTVERTEX_H
+
+#pragma once
+#include <QFloat16>
+#include <vector>
+#include "model/meshdata.h"
+
+enum class VertexFormat {
+    Full,     // Vertex, 32 bytes of floats
+    Compact   // CompactVertex, 16 bytes
+};
+
+// Quantized vertex, half the size of Vertex
+//  - position: unorm16 inside the mesh AABB, decoded as boundsMin + p * (boundsMax - boundsMin)
+//  - normal: octahedral encoding in two snorm16
+//  - texCoords: half floats
+struct CompactVertex {
+    quint16 position[4];  // w is padding to keep the normal 4 byte aligned
+    qint16 normal[2];
+    qfloat16 texCoords[2];
+};
+
+// Largest error quantization introduced anywhere in a mesh
+struct QuantizationError {
+    float position = 0.0f;       // world units
+    float normalDegrees = 0.0f;
+    float texCoord = 0.0f;       // uv units
+};
+
+// Limits a mesh has to stay under to be stored compact
+struct QuantizationTolerance {
+    float position = 0.0005f;    // half a millimetre at the garden's metre per cell scale
+    float normalDegrees = 0.5f;
+    float texCoord = 1.0f / 2048.0f;  // half a texel on a 1k texture, halfs are 2^-12 accurate in 0.5..1
+};
+
+class VertexQuantizer {
+
+public:
+    // Quantizes mesh against its bounds and measures the round trip error
+    static void quantize(const MeshData &mesh, std::vector<CompactVertex> &compact, QuantizationError &error);
+
+    // Quantizes only if the result is within tolerance, otherwise leaves compact empty
+    static bool tryQuantize(const MeshData &mesh, std::vector<CompactVertex> &compact,
+                            QuantizationError &error,
+                            const QuantizationTolerance &tolerance = QuantizationTolerance());
+
+    static void octEncode(const QVector3D &normal, qint16 encoded[2]);
+    static QVector3D octDecode(const qint16 encoded[2]);
+
+    // Back to full floats, the CPU side of what model.vert does with compact vertices
+    static Vertex dequantize(const CompactVertex &vertex, const QVector3D &boundsMin, const QVector3D &boundsMax);
+};
+
+
+#endif //GARDEN_SIMULATION_COMPACTVERTEX_H
@@ -0,0 +1,21 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_FILEHASH_H
+#define GARDEN_SIMULATION_FILEHASH_H
+
+#pragma once
+#include <QtGlobal>
+#include <string_view>
+
+// 64 bit FNV-1a, used to tell whether a source asset changed since it was baked/cached
+inline quint64 fnv1a64(std::string_view bytes, quint64 hash = 1469598103934665603ull) {
+    for (unsigned char c : bytes) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+#endif //GARDEN_SIMULATION_FILEHASH_H
@@ -0,0 +1,20 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_GARDENLIGHT_H
+#define GARDEN_SIMULATION_GARDENLIGHT_H
+
+#pragma once
+#include <QVector3D>
+
+// A grow lamp or path light, lit on top of the sun out to radius
+struct GardenLight {
+    QVector3D position;              // world space, grid cells are 1 apart
+    QVector3D color{1.0f, 1.0f, 1.0f};
+    float radius = 3.0f;             // no light at all past this
+    float intensity = 1.0f;
+};
+
+
+#endif //GARDEN_SIMULATION_GARDENLIGHT_H
@@ -24,8 +24,7 @@ bool GardenModel::addPlant(Plant::Type type, const QPoint& position) {
         return false;
     }
 
-    QString modelPath = QString("/Users/raphaelrusso/CLionProjects/garden_simulation/models/plants/%1.obj")
-            .arg(getPlantTypeName(type).toLower());
+    QString modelPath = QString("%1/%2.obj").arg(m_modelDirectory, getPlantTypeName(type).toLower());
 
     auto plant = std::make_unique<Plant>(type, modelPath, getPlantTypeName(type), "");
     plant->setGridPosition(position);
@@ -95,6 +94,11 @@ void GardenModel::handleMoistureUpdate(float value) {
     emit moistureChanged(value);
 }
 
+void GardenModel::setLights(const std::vector<GardenLight>& lights) {
+    m_lights = lights;
+    emit lightsChanged();
+}
+
 QString GardenModel::getPlantTypeName(Plant::Type type) {
     switch (type) {
         case Plant::Type::Carrot: return "Carrot";
@@ -121,6 +125,21 @@ bool GardenModel::saveGarden(const QString& filename) {
     }
 
     garden["plants"] = plants;
+
+    QJsonArray lights;
+    for (const GardenLight& light : m_lights) {
+        QJsonObject lightObj;
+        lightObj["x"] = light.position.x();
+        lightObj["y"] = light.position.y();
+        lightObj["z"] = light.position.z();
+        lightObj["r"] = light.color.x();
+        lightObj["g"] = light.color.y();
+        lightObj["b"] = light.color.z();
+        lightObj["radius"] = light.radius;
+        lightObj["intensity"] = light.intensity;
+        lights.append(lightObj);
+    }
+    garden["lights"] = lights;
     garden["gridSize"] = m_gridSize;
 
     QFile file(filename);
@@ -164,6 +183,18 @@ bool GardenModel::loadGarden(const QString& filename) {
         addPlant(type, pos);  // Create and move the plant into position
     }
 
+    // Older gardens have no lights
+    m_lights.clear();
+    for (const auto& lightRef : garden["lights"].toArray()) {
+        QJsonObject lightObj = lightRef.toObject();
+        GardenLight light;
+        light.position = QVector3D(lightObj["x"].toDouble(), lightObj["y"].toDouble(), lightObj["z"].toDouble());
+        light.color = QVector3D(lightObj["r"].toDouble(1.0), lightObj["g"].toDouble(1.0), lightObj["b"].toDouble(1.0));
+        light.radius = lightObj["radius"].toDouble(3.0);
+        light.intensity = lightObj["intensity"].toDouble(1.0);
+        m_lights.push_back(light);
+    }
+
     emit gardenLoaded();
     return true;
 }
\ No newline at end of file
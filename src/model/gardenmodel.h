@@ -5,6 +5,7 @@
 #ifndef GARDEN_SIMULATION_GARDENMODEL_H
 #define GARDEN_SIMULATION_GARDENMODEL_H
 
+#include "gardenlight.h"
 #include "plant.h"
 #include "sensordata.h"
 #include <QObject>
@@ -30,6 +31,14 @@ public:
     int getGridSize() const { return m_gridSize; }
     bool isValidGridPosition(const QPoint& position) const;
 
+    // Where the plant OBJs are read from, the default is the development checkout
+    void setModelDirectory(const QString& directory) { m_modelDirectory = directory; }
+    const QString& getModelDirectory() const { return m_modelDirectory; }
+
+    // Lamps and path lights, saved with the garden
+    const std::vector<GardenLight>& getLights() const { return m_lights; }
+    void setLights(const std::vector<GardenLight>& lights);
+
     // Sensor management
     void setTemperatureSensor(std::unique_ptr<SensorInterface> sensor);
     SensorInterface* getTemperatureSensor() const { return m_temperatureSensor.get(); }
@@ -50,6 +59,7 @@ signals:
     void plantRemoved(const QPoint& position);
     void temperatureChanged(float temperature);
     void moistureChanged(float moisture);
+    void lightsChanged();
     void gardenLoaded();
     void gardenSaved();
 
@@ -60,7 +70,9 @@ public slots:
 private:
     int m_gridSize;
     std::vector<std::vector<std::unique_ptr<Plant>>> m_grid;
+    std::vector<GardenLight> m_lights;
     SensorData m_sensorData;
+    QString m_modelDirectory = GARDEN_SOURCE_DIR "/models/plants";
     std::unique_ptr<SensorInterface> m_temperatureSensor;
     std::unique_ptr<SensorInterface> m_moistureSensor;
     QString getPlantTypeName(Plant::Type type);
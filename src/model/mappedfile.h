@@ -0,0 +1,69 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_MAPPEDFILE_H
+#define GARDEN_SIMULATION_MAPPEDFILE_H
+
+#pragma once
+#include <QFile>
+#include <string_view>
+
+// Read only memory mapping of a whole file, unmapped when it goes out of scope
+class MappedFile {
+
+public:
+    MappedFile() = default;
+    explicit MappedFile(const QString &path) { open(path); }
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const QString &path) {
+        close();
+        m_file.setFileName(path);
+        if (!m_file.open(QIODevice::ReadOnly)) {
+            return false;
+        }
+        m_size = m_file.size();
+        if (m_size == 0) {
+            // Nothing to map, still a valid (empty) file
+            return true;
+        }
+        m_data = m_file.map(0, m_size);
+        if (!m_data) {
+            m_file.close();
+            m_size = 0;
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (m_data) {
+            m_file.unmap(m_data);
+            m_data = nullptr;
+        }
+        if (m_file.isOpen()) {
+            m_file.close();
+        }
+        m_size = 0;
+    }
+
+    bool isOpen() const { return m_file.isOpen(); }
+    const uchar* data() const { return m_data; }
+    qint64 size() const { return m_size; }
+
+    std::string_view view() const {
+        return m_data ? std::string_view(reinterpret_cast<const char*>(m_data), size_t(m_size))
+                      : std::string_view();
+    }
+
+private:
+    QFile m_file;
+    uchar* m_data = nullptr;
+    qint64 m_size = 0;
+};
+
+#endif //GARDEN_SIMULATION_MAPPEDFILE_H
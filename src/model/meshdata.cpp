@@ -0,0 +1,35 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include "meshdata.h"
+#include <limits>
+
+void MeshData::computeBounds() {
+    boundsMin = QVector3D(
+            std::numeric_limits<float>::max(),
+            std::numeric_limits<float>::max(),
+            std::numeric_limits<float>::max()
+    );
+
+    boundsMax = QVector3D(
+            std::numeric_limits<float>::lowest(),
+            std::numeric_limits<float>::lowest(),
+            std::numeric_limits<float>::lowest()
+    );
+
+    for (const auto &vertex : vertices) {
+        boundsMin.setX(qMin(boundsMin.x(), vertex.position.x()));
+        boundsMin.setY(qMin(boundsMin.y(), vertex.position.y()));
+        boundsMin.setZ(qMin(boundsMin.z(), vertex.position.z()));
+
+        boundsMax.setX(qMax(boundsMax.x(), vertex.position.x()));
+        boundsMax.setY(qMax(boundsMax.y(), vertex.position.y()));
+        boundsMax.setZ(qMax(boundsMax.z(), vertex.position.z()));
+    }
+
+    if (vertices.empty()) {
+        boundsMin = QVector3D();
+        boundsMax = QVector3D();
+    }
+}
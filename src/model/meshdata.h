@@ -0,0 +1,51 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_MESHDATA_H
+#define GARDEN_SIMULATION_MESHDATA_H
+
+#pragma once
+#include <QVector3D>
+#include <QVector2D>
+#include <QString>
+#include <vector>
+
+struct Vertex {
+    QVector3D position;
+    QVector3D normal;
+    QVector2D texCoords;
+};
+
+struct Material {
+    QVector3D ambient = QVector3D(0.1f, 0.1f, 0.1f);   // Darker ambient by default
+    QVector3D diffuse = QVector3D(0.6f, 0.4f, 0.2f);   // Default to wooden brown color
+    QVector3D specular = QVector3D(0.1f, 0.1f, 0.1f);
+    float shininess = 4.0f;
+    QString diffuseMap;
+    QString normalMap;
+    float bumpMultiplier = 1.0f;
+};
+
+// CPU side result of loading a mesh file, no GL state in here so tools can use it
+struct MeshData {
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    Material material;
+    QString mtlPath;
+
+    QVector3D boundsMin;
+    QVector3D boundsMax;
+
+    // Triangle corners in the source file, i.e. vertices an unindexed mesh would need
+    size_t sourceCornerCount = 0;
+
+    void computeBounds();
+
+    // How many source corners each stored vertex stands in for
+    float compressionRatio() const {
+        return vertices.empty() ? 1.0f : float(sourceCornerCount) / float(vertices.size());
+    }
+};
+
+#endif //GARDEN_SIMULATION_MESHDATA_H
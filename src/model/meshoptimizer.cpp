@@ -0,0 +1,342 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include "meshoptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+
+// Forsyth scoring constants, from "Linear-Speed Vertex Cache Optimisation"
+constexpr int ForsythCacheSize = 32;
+constexpr float CacheDecayPower = 1.5f;
+constexpr float LastTriangleScore = 0.75f;
+constexpr float ValenceBoostScale = 2.0f;
+constexpr float ValenceBoostPower = 0.5f;
+
+// Smallest cluster the overdraw pass will split off, below this the cache loss isn't worth it
+constexpr size_t MinClusterTriangles = 16;
+
+constexpr size_t NoTriangle = ~size_t(0);
+
+float vertexScore(int cachePosition, unsigned remainingTriangles) {
+    // No triangles left to draw, never pick this vertex
+    if (remainingTriangles == 0) return -1.0f;
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            // Used by the last triangle, fixed score so the strip doesn't just keep going
+            score = LastTriangleScore;
+        } else {
+            float scale = 1.0f / float(ForsythCacheSize - 3);
+            score = std::pow(1.0f - float(cachePosition - 3) * scale, CacheDecayPower);
+        }
+    }
+
+    // Boost vertices with few triangles left so they get finished off and leave the cache
+    score += ValenceBoostScale * std::pow(float(remainingTriangles), -ValenceBoostPower);
+    return score;
+}
+
+}
+
+VertexCacheStats MeshOptimizer::analyzeVertexCache(const std::vector<unsigned int> &indices,
+                                                   size_t vertexCount, int cacheSize) {
+    VertexCacheStats stats;
+    if (indices.empty() || vertexCount == 0) return stats;
+
+    // FIFO: a vertex is a hit while fewer than cacheSize misses happened since it was loaded
+    std::vector<unsigned> loadedAt(vertexCount, 0);
+    std::vector<char> referenced(vertexCount, 0);
+    unsigned timestamp = unsigned(cacheSize) + 1;
+    size_t misses = 0;
+    size_t uniqueVertices = 0;
+
+    for (unsigned int index : indices) {
+        if (timestamp - loadedAt[index] > unsigned(cacheSize)) {
+            loadedAt[index] = timestamp++;
+            ++misses;
+        }
+        if (!referenced[index]) {
+            referenced[index] = 1;
+            ++uniqueVertices;
+        }
+    }
+
+    stats.acmr = float(misses) / float(indices.size() / 3);
+    stats.atvr = float(misses) / float(uniqueVertices);
+    return stats;
+}
+
+void MeshOptimizer::optimizeVertexCache(std::vector<unsigned int> &indices, size_t vertexCount) {
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) return;
+
+    // Vertex -> triangle adjacency in one flat array
+    std::vector<unsigned> remaining(vertexCount, 0);
+    for (unsigned int index : indices) ++remaining[index];
+
+    std::vector<unsigned> offsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v) offsets[v + 1] = offsets[v] + remaining[v];
+
+    std::vector<unsigned> adjacency(indices.size());
+    {
+        std::vector<unsigned> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); ++i) {
+            adjacency[cursor[indices[i]]++] = unsigned(i / 3);
+        }
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScores(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        vertexScores[v] = vertexScore(-1, remaining[v]);
+    }
+
+    std::vector<float> triangleScores(triangleCount);
+    size_t best = NoTriangle;
+    float bestScore = -1.0f;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] +
+                            vertexScores[indices[t * 3 + 2]];
+        if (triangleScores[t] > bestScore) {
+            bestScore = triangleScores[t];
+            best = t;
+        }
+    }
+
+    std::vector<char> emitted(triangleCount, 0);
+    std::vector<unsigned int> output;
+    output.reserve(indices.size());
+
+    unsigned cache[ForsythCacheSize + 3];
+    int cacheCount = 0;
+    size_t deadEndCursor = 0;
+
+    for (size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount) {
+        if (best == NoTriangle) {
+            // Nothing in the cache touches a live triangle, restart at the next unused one
+            while (emitted[deadEndCursor]) ++deadEndCursor;
+            best = deadEndCursor;
+        }
+
+        const unsigned *triangle = &indices[best * 3];
+        output.insert(output.end(), triangle, triangle + 3);
+        emitted[best] = 1;
+
+        // Drop the triangle from its vertices' adjacency lists
+        for (int corner = 0; corner < 3; ++corner) {
+            unsigned v = triangle[corner];
+            unsigned *list = &adjacency[offsets[v]];
+            unsigned *listEnd = list + remaining[v];
+            unsigned *found = std::find(list, listEnd, unsigned(best));
+            if (found != listEnd) {
+                *found = *(listEnd - 1);
+                --remaining[v];
+            }
+        }
+
+        // LRU update: the triangle goes in front, everything else slides back
+        unsigned newCache[ForsythCacheSize + 3];
+        int newCount = 0;
+        for (int corner = 0; corner < 3; ++corner) {
+            unsigned v = triangle[corner];
+            if (std::find(newCache, newCache + newCount, v) == newCache + newCount) {
+                newCache[newCount++] = v;
+            }
+        }
+        for (int i = 0; i < cacheCount; ++i) {
+            unsigned v = cache[i];
+            if (std::find(newCache, newCache + newCount, v) == newCache + newCount) {
+                newCache[newCount++] = v;
+            }
+        }
+
+        // Rescore everything that moved, including vertices that just fell out
+        for (int i = 0; i < newCount; ++i) {
+            unsigned v = newCache[i];
+            cachePosition[v] = i < ForsythCacheSize ? i : -1;
+            vertexScores[v] = vertexScore(cachePosition[v], remaining[v]);
+        }
+
+        best = NoTriangle;
+        bestScore = -1.0f;
+        for (int i = 0; i < newCount; ++i) {
+            unsigned v = newCache[i];
+            for (unsigned j = offsets[v]; j < offsets[v] + remaining[v]; ++j) {
+                unsigned t = adjacency[j];
+                triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] +
+                                    vertexScores[indices[t * 3 + 2]];
+                if (triangleScores[t] > bestScore) {
+                    bestScore = triangleScores[t];
+                    best = t;
+                }
+            }
+        }
+
+        cacheCount = std::min(newCount, ForsythCacheSize);
+        std::copy(newCache, newCache + cacheCount, cache);
+    }
+
+    indices.swap(output);
+}
+
+void MeshOptimizer::optimizeOverdraw(std::vector<unsigned int> &indices, const std::vector<Vertex> &vertices,
+                                     float threshold) {
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount < MinClusterTriangles * 2) return;
+
+    constexpr unsigned CacheSize = 16;
+
+    // Hard boundaries: triangles where all three vertices miss, the order restarts there anyway
+    std::vector<size_t> hardClusters;
+    {
+        std::vector<unsigned> loadedAt(vertices.size(), 0);
+        unsigned timestamp = CacheSize + 1;
+        for (size_t t = 0; t < triangleCount; ++t) {
+            int misses = 0;
+            for (int corner = 0; corner < 3; ++corner) {
+                unsigned v = indices[t * 3 + corner];
+                if (timestamp - loadedAt[v] > CacheSize) {
+                    loadedAt[v] = timestamp++;
+                    ++misses;
+                }
+            }
+            if (t == 0 || misses == 3) hardClusters.push_back(t);
+        }
+    }
+    hardClusters.push_back(triangleCount);
+
+    // Soft boundaries: split hard clusters further wherever a fresh cache there costs
+    // at most threshold times the cluster's own ACMR
+    std::vector<size_t> clusters;
+    {
+        std::vector<unsigned> loadedAt(vertices.size(), 0);
+        unsigned timestamp = CacheSize + 1;
+
+        for (size_t c = 0; c + 1 < hardClusters.size(); ++c) {
+            size_t start = hardClusters[c];
+            size_t end = hardClusters[c + 1];
+
+            timestamp += CacheSize + 1;
+            size_t clusterMisses = 0;
+            for (size_t t = start; t < end; ++t) {
+                for (int corner = 0; corner < 3; ++corner) {
+                    unsigned v = indices[t * 3 + corner];
+                    if (timestamp - loadedAt[v] > CacheSize) {
+                        loadedAt[v] = timestamp++;
+                        ++clusterMisses;
+                    }
+                }
+            }
+            float clusterAcmr = float(clusterMisses) / float(end - start);
+
+            clusters.push_back(start);
+            timestamp += CacheSize + 1;
+            size_t subStart = start;
+            size_t subMisses = 0;
+            for (size_t t = start; t < end; ++t) {
+                for (int corner = 0; corner < 3; ++corner) {
+                    unsigned v = indices[t * 3 + corner];
+                    if (timestamp - loadedAt[v] > CacheSize) {
+                        loadedAt[v] = timestamp++;
+                        ++subMisses;
+                    }
+                }
+
+                size_t subSize = t + 1 - subStart;
+                bool roomLeft = end - (t + 1) >= MinClusterTriangles;
+                if (subSize >= MinClusterTriangles && roomLeft &&
+                    float(subMisses) / float(subSize) <= clusterAcmr * threshold) {
+                    clusters.push_back(t + 1);
+                    subStart = t + 1;
+                    subMisses = 0;
+                    timestamp += CacheSize + 1;  // next cluster starts cold
+                }
+            }
+        }
+    }
+    clusters.push_back(triangleCount);
+
+    // Area weighted centroid and normal of each cluster and of the whole mesh
+    size_t clusterCount = clusters.size() - 1;
+    std::vector<QVector3D> centroids(clusterCount);
+    std::vector<QVector3D> normals(clusterCount);
+    QVector3D meshCentroid;
+    float meshArea = 0.0f;
+
+    for (size_t c = 0; c < clusterCount; ++c) {
+        QVector3D centroid;
+        QVector3D normal;
+        float area = 0.0f;
+        for (size_t t = clusters[c]; t < clusters[c + 1]; ++t) {
+            const QVector3D &a = vertices[indices[t * 3]].position;
+            const QVector3D &b = vertices[indices[t * 3 + 1]].position;
+            const QVector3D &d = vertices[indices[t * 3 + 2]].position;
+            QVector3D cross = QVector3D::crossProduct(b - a, d - a);
+            float triangleArea = cross.length();
+            centroid += (a + b + d) * (triangleArea / 3.0f);
+            normal += cross;
+            area += triangleArea;
+        }
+        centroids[c] = area > 0.0f ? centroid / area : vertices[indices[clusters[c] * 3]].position;
+        normals[c] = normal.normalized();
+        meshCentroid += centroid;
+        meshArea += area;
+    }
+    if (meshArea > 0.0f) meshCentroid /= meshArea;
+
+    // Clusters facing away from the middle are drawn first, they tend to be in front
+    std::vector<float> sortKeys(clusterCount);
+    for (size_t c = 0; c < clusterCount; ++c) {
+        sortKeys[c] = QVector3D::dotProduct(centroids[c] - meshCentroid, normals[c]);
+    }
+
+    std::vector<size_t> order(clusterCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&sortKeys](size_t lhs, size_t rhs) {
+        return sortKeys[lhs] > sortKeys[rhs];
+    });
+
+    std::vector<unsigned int> output;
+    output.reserve(indices.size());
+    for (size_t c : order) {
+        output.insert(output.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+    }
+    indices.swap(output);
+}
+
+void MeshOptimizer::optimizeVertexFetch(std::vector<Vertex> &vertices, std::vector<unsigned int> &indices) {
+    constexpr unsigned Unassigned = ~0u;
+    std::vector<unsigned> remap(vertices.size(), Unassigned);
+    std::vector<Vertex> reordered;
+    reordered.reserve(vertices.size());
+
+    // First use order, vertices nothing references are dropped
+    for (unsigned int &index : indices) {
+        if (remap[index] == Unassigned) {
+            remap[index] = unsigned(reordered.size());
+            reordered.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+
+    vertices.swap(reordered);
+}
+
+MeshOptimizer::Report MeshOptimizer::optimize(MeshData &mesh, bool reduceOverdraw) {
+    Report report;
+    report.before = analyzeVertexCache(mesh.indices, mesh.vertices.size());
+
+    optimizeVertexCache(mesh.indices, mesh.vertices.size());
+    if (reduceOverdraw) {
+        optimizeOverdraw(mesh.indices, mesh.vertices);
+    }
+    optimizeVertexFetch(mesh.vertices, mesh.indices);
+
+    report.after = analyzeVertexCache(mesh.indices, mesh.vertices.size());
+    return report;
+}
@@ -0,0 +1,50 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_MESHOPTIMIZER_H
+#define GARDEN_SIMULATION_MESHOPTIMIZER_H
+
+#pragma once
+#include <vector>
+#include "model/meshdata.h"
+
+// Post-transform vertex cache numbers for an index buffer
+// ACMR: vertex shader runs per triangle (0.5 is ideal for big grids, 3 is no reuse)
+// ATVR: vertex shader runs per unique vertex (1 is ideal)
+struct VertexCacheStats {
+    float acmr = 0.0f;
+    float atvr = 0.0f;
+};
+
+// Load/bake time reordering of indexed meshes so the GPU does less vertex work
+//  - optimizeVertexCache: Forsyth's linear speed triangle order for an LRU cache
+//  - optimizeOverdraw: splits that order into clusters and sorts them outside in,
+//    trading a little cache efficiency for earlier depth rejection
+//  - optimizeVertexFetch: renumbers vertices in first use order so fetches stream
+class MeshOptimizer {
+
+public:
+    struct Report {
+        VertexCacheStats before;
+        VertexCacheStats after;
+    };
+
+    // Runs the whole pipeline on mesh in place, overdraw sorting is opt in
+    static Report optimize(MeshData &mesh, bool reduceOverdraw = false);
+
+    // Simulates a FIFO cache, the common hardware model, of the given size
+    static VertexCacheStats analyzeVertexCache(const std::vector<unsigned int> &indices,
+                                               size_t vertexCount, int cacheSize = 16);
+
+    static void optimizeVertexCache(std::vector<unsigned int> &indices, size_t vertexCount);
+
+    // threshold is how much worse than the cache optimal ACMR a cluster may get
+    static void optimizeOverdraw(std::vector<unsigned int> &indices, const std::vector<Vertex> &vertices,
+                                 float threshold = 1.05f);
+
+    static void optimizeVertexFetch(std::vector<Vertex> &vertices, std::vector<unsigned int> &indices);
+};
+
+
+#endif //GARDEN_SIMULATION_MESHOPTIMIZER_H
@@ -7,24 +7,15 @@
 
 #pragma once
 #include <QVector3D>
-#include <QOpenGLFunctions_3_3_Core>
+#include <QMatrix4x4>
+#include <memory>
 #include "renderer/shader.h"
+#include "renderer/frustum.h"
+#include "renderer/mesh.h"
 
-struct Vertex {
-    QVector3D position;
-    QVector3D normal;
-    QVector2D texCoords;
-};
-
-struct Material {
-    QVector3D ambient;
-    QVector3D diffuse;
-    QVector3D specular;
-    float shininess;
-    QString diffuseMap;
-};
-
-class Model: protected QOpenGLFunctions_3_3_Core {
+// One placed instance of a mesh
+// Only the transform lives here, geometry/material/textures are shared through AssetCache
+class Model {
 
 public:
     Model();
@@ -36,12 +27,14 @@ public:
 
     QMatrix4x4 getModelMatrix() const;
 
-private:
-    std::vector<Vertex> m_vertices;
-    std::vector<unsigned int> m_indices;
-    Material m_material;
+    // Mesh bounds moved to where this instance is, empty until the mesh knows its bounds
+    Aabb getWorldBounds() const;
 
-    GLuint  m_VAO, m_VBO, m_EBO;
+    Mesh* getMesh() const { return m_mesh.get(); }
+    const std::shared_ptr<Mesh>& getSharedMesh() const { return m_mesh; }
+
+private:
+    std::shared_ptr<Mesh> m_mesh;
 
     QVector3D m_position;
 public:
@@ -52,21 +45,8 @@ public:
     void setScale(const QVector3D &mScale);
 
 private:
-    struct Texture {
-        GLuint id;
-        QString type;  // like diffuse, normal, etc
-        QString path;
-    };
-
     QVector3D m_rotation;
     QVector3D m_scale;
-
-    bool parseMTL(const QString &mtlPath);
-    void setupMesh();
-
-    std::vector<Texture> m_textures;
-
-    GLuint loadTexture(const QString& path);
 };
 
 
@@ -0,0 +1,329 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include "objparser.h"
+#include "model/mappedfile.h"
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Walks one line of the mapped file, never copies anything out of it
+struct LineCursor {
+    const char* p;
+    const char* end;
+
+    void skipSpaces() {
+        while (p < end && isSpace(*p)) ++p;
+    }
+
+    std::string_view token() {
+        skipSpaces();
+        const char* start = p;
+        while (p < end && !isSpace(*p)) ++p;
+        return std::string_view(start, size_t(p - start));
+    }
+
+    // Whatever is left on the line without surrounding whitespace, used for paths
+    std::string_view rest() {
+        skipSpaces();
+        const char* last = end;
+        while (last > p && isSpace(*(last - 1))) --last;
+        std::string_view result(p, size_t(last - p));
+        p = end;
+        return result;
+    }
+
+    bool readFloat(float &value) {
+        skipSpaces();
+        if (p < end && *p == '+') ++p;  // from_chars doesn't take a leading plus
+        auto result = std::from_chars(p, end, value);
+        if (result.ec != std::errc()) return false;
+        p = result.ptr;
+        return true;
+    }
+
+    bool readVec3(QVector3D &value) {
+        float x, y, z;
+        if (!readFloat(x) || !readFloat(y) || !readFloat(z)) return false;
+        value = QVector3D(x, y, z);
+        return true;
+    }
+};
+
+// Finds the end of the line starting at p, not including the newline
+inline const char* lineEnd(const char* p, const char* end) {
+    const void* newline = std::memchr(p, '\n', size_t(end - p));
+    return newline ? static_cast<const char*>(newline) : end;
+}
+
+// Resolves a 1 based (or negative, relative) OBJ index into a 0 based one
+inline bool resolveIndex(int index, size_t count, int &resolved) {
+    if (index > 0) {
+        resolved = index - 1;
+    } else if (index < 0) {
+        resolved = int(count) + index;
+    } else {
+        return false;
+    }
+    return resolved >= 0 && size_t(resolved) < count;
+}
+
+bool readInt(const char* &p, const char* end, int &value) {
+    if (p < end && *p == '+') ++p;
+    auto result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) return false;
+    p = result.ptr;
+    return true;
+}
+
+QString resolvePath(std::string_view path, const QString &baseDir) {
+    QString resolved = QString::fromUtf8(path.data(), qsizetype(path.size()));
+    if (QFileInfo(resolved).isRelative()) {
+        resolved = QDir(baseDir).absoluteFilePath(resolved);
+    }
+    return resolved;
+}
+
+}
+
+bool ObjParser::fail(const QString &message, int lineNumber) {
+    m_error = QString("line %1: %2").arg(lineNumber).arg(message);
+    return false;
+}
+
+bool ObjParser::parse(const QString &objPath, MeshData &mesh) {
+    MappedFile file(objPath);
+    if (!file.isOpen()) {
+        m_error = "Failed to open OBJ file: " + objPath;
+        return false;
+    }
+
+    if (!parseBuffer(file.view(), QFileInfo(objPath).path(), mesh)) {
+        m_error = objPath + " " + m_error;
+        return false;
+    }
+
+    // Load material if available
+    if (!mesh.mtlPath.isEmpty() && !parseMaterial(mesh.mtlPath, mesh.material)) {
+        qDebug() << "Failed to parse MTL file:" << m_error;
+    }
+    return true;
+}
+
+bool ObjParser::parseBuffer(std::string_view data, const QString &baseDir, MeshData &mesh) {
+    m_error.clear();
+    m_positions.clear();
+    m_normals.clear();
+    m_texCoords.clear();
+    mesh.vertices.clear();
+    mesh.indices.clear();
+    mesh.material = Material();
+    mesh.mtlPath.clear();
+
+    const char* begin = data.data();
+    const char* end = begin + data.size();
+
+    // Counting pass so every array is allocated exactly once
+    size_t positionCount = 0, normalCount = 0, texCoordCount = 0, faceCount = 0, cornerCount = 0;
+    for (const char* p = begin; p < end; ) {
+        const char* eol = lineEnd(p, end);
+        while (p < eol && isSpace(*p)) ++p;
+        if (eol - p >= 2) {
+            if (p[0] == 'v' && isSpace(p[1])) ++positionCount;
+            else if (p[0] == 'v' && p[1] == 'n') ++normalCount;
+            else if (p[0] == 'v' && p[1] == 't') ++texCoordCount;
+            else if (p[0] == 'f' && isSpace(p[1])) {
+                ++faceCount;
+                LineCursor face{p + 1, eol};
+                while (!face.token().empty()) ++cornerCount;
+            }
+        }
+        p = eol + 1;
+    }
+
+    m_positions.reserve(positionCount);
+    m_normals.reserve(normalCount);
+    m_texCoords.reserve(texCoordCount);
+
+    // A fan over n corners gives n - 2 triangles
+    size_t triangleCount = cornerCount > 2 * faceCount ? cornerCount - 2 * faceCount : 0;
+    mesh.indices.reserve(triangleCount * 3);
+    mesh.vertices.reserve(qMin(cornerCount, qMax(positionCount, qMax(normalCount, texCoordCount))));
+    mesh.sourceCornerCount = triangleCount * 3;
+
+    // Open addressing table from (position, uv, normal) to output vertex, kept at most half full
+    size_t tableSize = 16;
+    while (tableSize < cornerCount * 2) tableSize <<= 1;
+    m_cornerTable.assign(tableSize, CornerSlot{});
+    const size_t tableMask = tableSize - 1;
+
+    int lineNumber = 0;
+    for (const char* p = begin; p < end; ) {
+        const char* eol = lineEnd(p, end);
+        ++lineNumber;
+        LineCursor line{p, eol};
+        p = eol + 1;
+
+        std::string_view keyword = line.token();
+        if (keyword.empty() || keyword[0] == '#') continue;
+
+        if (keyword == "v") {
+            // Vertex position
+            QVector3D position;
+            if (!line.readVec3(position)) return fail("bad vertex position", lineNumber);
+            m_positions.push_back(position);
+        }
+        else if (keyword == "vt") {
+            // Texture coordinate
+            float u, v;
+            if (!line.readFloat(u) || !line.readFloat(v)) return fail("bad texture coordinate", lineNumber);
+            m_texCoords.push_back(QVector2D(u, v));
+        }
+        else if (keyword == "vn") {
+            // Vertex normal
+            QVector3D normal;
+            if (!line.readVec3(normal)) return fail("bad vertex normal", lineNumber);
+            m_normals.push_back(normal);
+        }
+        else if (keyword == "f") {
+            // Face definition, corners are v, v/vt, v//vn or v/vt/vn
+            m_faceVertices.clear();
+            for (std::string_view corner = line.token(); !corner.empty(); corner = line.token()) {
+                const char* c = corner.data();
+                const char* cornerEnd = c + corner.size();
+                int index;
+                int position = -1, texCoord = -1, normal = -1;
+
+                if (!readInt(c, cornerEnd, index) || !resolveIndex(index, m_positions.size(), position)) {
+                    return fail("bad position index", lineNumber);
+                }
+
+                if (c < cornerEnd && *c == '/') {
+                    ++c;
+                    if (c < cornerEnd && *c != '/') {
+                        if (!readInt(c, cornerEnd, index) || !resolveIndex(index, m_texCoords.size(), texCoord)) {
+                            return fail("bad texture coordinate index", lineNumber);
+                        }
+                    }
+                    if (c < cornerEnd && *c == '/') {
+                        ++c;
+                        if (!readInt(c, cornerEnd, index) || !resolveIndex(index, m_normals.size(), normal)) {
+                            return fail("bad normal index", lineNumber);
+                        }
+                    }
+                }
+
+                // Reuse the vertex if this exact corner was seen before
+                size_t hash = (size_t(position) * 73856093u) ^ (size_t(texCoord + 1) * 19349663u) ^
+                              (size_t(normal + 1) * 83492791u);
+                size_t slot = (hash ^ (hash >> 15)) & tableMask;
+                while (m_cornerTable[slot].vertex != CornerSlot::Empty &&
+                       !(m_cornerTable[slot].position == position &&
+                         m_cornerTable[slot].texCoord == texCoord &&
+                         m_cornerTable[slot].normal == normal)) {
+                    slot = (slot + 1) & tableMask;
+                }
+
+                CornerSlot &entry = m_cornerTable[slot];
+                if (entry.vertex == CornerSlot::Empty) {
+                    Vertex vertex;
+                    vertex.position = m_positions[position];
+                    if (texCoord >= 0) vertex.texCoords = m_texCoords[texCoord];
+                    if (normal >= 0) vertex.normal = m_normals[normal];
+
+                    entry = CornerSlot{position, texCoord, normal, unsigned(mesh.vertices.size())};
+                    mesh.vertices.push_back(vertex);
+                }
+                m_faceVertices.push_back(entry.vertex);
+            }
+
+            if (m_faceVertices.size() < 3) return fail("face with fewer than 3 corners", lineNumber);
+
+            // Fan triangulate quads and n-gons around the first corner
+            for (size_t i = 1; i + 1 < m_faceVertices.size(); ++i) {
+                mesh.indices.push_back(m_faceVertices[0]);
+                mesh.indices.push_back(m_faceVertices[i]);
+                mesh.indices.push_back(m_faceVertices[i + 1]);
+            }
+        }
+        else if (keyword == "mtllib") {
+            // Get MTL file path relative to OBJ file
+            mesh.mtlPath = resolvePath(line.rest(), baseDir);
+        }
+    }
+
+    mesh.computeBounds();
+    return true;
+}
+
+bool ObjParser::parseMaterial(const QString &mtlPath, Material &material) {
+    MappedFile file(mtlPath);
+    if (!file.isOpen()) {
+        m_error = "Failed to open MTL file: " + mtlPath;
+        return false;
+    }
+
+    // Texture paths in the MTL are relative to the MTL itself
+    return parseMaterialBuffer(file.view(), QFileInfo(mtlPath).absolutePath(), material);
+}
+
+bool ObjParser::parseMaterialBuffer(std::string_view data, const QString &baseDir, Material &material) {
+    m_error.clear();
+    material = Material();
+
+    const char* begin = data.data();
+    const char* end = begin + data.size();
+    bool seenMaterial = false;
+
+    int lineNumber = 0;
+    for (const char* p = begin; p < end; ) {
+        const char* eol = lineEnd(p, end);
+        ++lineNumber;
+        LineCursor line{p, eol};
+        p = eol + 1;
+
+        std::string_view keyword = line.token();
+        if (keyword.empty() || keyword[0] == '#') continue;
+
+        if (keyword == "newmtl") {
+            // Meshes here only ever use one material, stop at the second one
+            if (seenMaterial) break;
+            seenMaterial = true;
+        }
+        else if (keyword == "Ka") {
+            if (!line.readVec3(material.ambient)) return fail("bad Ka", lineNumber);
+        }
+        else if (keyword == "Kd") {
+            if (!line.readVec3(material.diffuse)) return fail("bad Kd", lineNumber);
+        }
+        else if (keyword == "Ks") {
+            if (!line.readVec3(material.specular)) return fail("bad Ks", lineNumber);
+        }
+        else if (keyword == "Ns") {
+            if (!line.readFloat(material.shininess)) return fail("bad Ns", lineNumber);
+        }
+        else if (keyword == "map_Kd") {
+            material.diffuseMap = resolvePath(line.rest(), baseDir);
+        }
+        else if (keyword == "map_Bump" || keyword == "bump") {
+            // Handle normal map parameters (-bm intensity value)
+            LineCursor options = line;
+            if (options.token() == "-bm") {
+                if (!options.readFloat(material.bumpMultiplier)) return fail("bad -bm value", lineNumber);
+                line = options;
+            }
+            material.normalMap = resolvePath(line.rest(), baseDir);
+        }
+    }
+
+    return true;
+}
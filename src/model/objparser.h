@@ -0,0 +1,56 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_OBJPARSER_H
+#define GARDEN_SIMULATION_OBJPARSER_H
+
+#pragma once
+#include <QString>
+#include <string_view>
+#include <vector>
+#include "model/meshdata.h"
+
+// OBJ/MTL reader that memory maps the file and tokenizes it in place
+// Numbers go straight from the mapped bytes through std::from_chars, so parsing a
+// line doesn't allocate anything. Output arrays are sized by a counting pass first
+// Faces come out as an indexed triangle list, identical (position, uv, normal)
+// corners share one vertex and quads/n-gons are fan triangulated
+class ObjParser {
+
+public:
+    // Parses an OBJ file (and its mtllib if there is one) into mesh
+    bool parse(const QString &objPath, MeshData &mesh);
+
+    // Same as parse but from a buffer already in memory, baseDir resolves mtllib
+    bool parseBuffer(std::string_view data, const QString &baseDir, MeshData &mesh);
+
+    // Parses the first material in an MTL file, texture paths come back absolute
+    bool parseMaterial(const QString &mtlPath, Material &material);
+    bool parseMaterialBuffer(std::string_view data, const QString &baseDir, Material &material);
+
+    const QString& getError() const { return m_error; }
+
+private:
+    // Scratch arrays reused between files so repeated loads don't reallocate
+    std::vector<QVector3D> m_positions;
+    std::vector<QVector3D> m_normals;
+    std::vector<QVector2D> m_texCoords;
+
+    struct CornerSlot {
+        static constexpr unsigned Empty = ~0u;
+        int position = -1;
+        int texCoord = -1;
+        int normal = -1;
+        unsigned vertex = Empty;
+    };
+    std::vector<CornerSlot> m_cornerTable;
+    std::vector<unsigned> m_faceVertices;
+
+    QString m_error;
+
+    bool fail(const QString &message, int lineNumber);
+};
+
+
+#endif //GARDEN_SIMULATION_OBJPARSER_H
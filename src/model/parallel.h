@@ -0,0 +1,45 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_PARALLEL_H
+#define GARDEN_SIMULATION_PARALLEL_H
+
+#pragma once
+#include <QSemaphore>
+#include <QThreadPool>
+#include <algorithm>
+#include <atomic>
+
+// Runs fn(first, end) over [0, count) split across the global thread pool and the calling thread
+// Each chunk gets at least minPerThread items, so small jobs stay on the calling thread
+// Helpers are only taken if the pool has one free, so calls from inside other pool jobs (like
+// AssetLoader's) can't pile up threads, the caller just works through whatever is left
+template<typename Fn>
+void parallelFor(int count, int minPerThread, Fn &&fn) {
+    QThreadPool *pool = QThreadPool::globalInstance();
+    int threads = std::clamp(count / std::max(1, minPerThread), 1, std::max(1, pool->maxThreadCount()));
+    if (threads == 1) {
+        fn(0, count);
+        return;
+    }
+
+    int chunk = (count + threads - 1) / threads;
+    std::atomic<int> next{0};
+    auto work = [&fn, &next, count, chunk]() {
+        for (int first = next.fetch_add(chunk); first < count; first = next.fetch_add(chunk)) {
+            fn(first, std::min(count, first + chunk));
+        }
+    };
+
+    QSemaphore done;
+    int helpers = 0;
+    for (int i = 1; i < threads; ++i) {
+        if (!pool->tryStart([&work, &done]() { work(); done.release(); })) break;
+        ++helpers;
+    }
+    work();
+    done.acquire(helpers);
+}
+
+#endif //GARDEN_SIMULATION_PARALLEL_H
@@ -0,0 +1,47 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include "sourcestamp.h"
+#include "model/filehash.h"
+#include "model/mappedfile.h"
+#include <QDateTime>
+#include <QFileInfo>
+
+namespace {
+
+bool statFile(const QString &path, SourceStamp &stamp) {
+    QFileInfo info(path);
+    if (!info.exists()) return false;
+    stamp.size = quint64(info.size());
+    stamp.modified = info.lastModified().toMSecsSinceEpoch();
+    stamp.hash = 0;
+    return true;
+}
+
+bool hashFile(const QString &path, quint64 &hash) {
+    MappedFile file(path);
+    if (!file.isOpen()) return false;
+    hash = fnv1a64(file.view());
+    return true;
+}
+
+}
+
+bool SourceStamp::make(const QString &path, SourceStamp &stamp) {
+    return statFile(path, stamp) && hashFile(path, stamp.hash);
+}
+
+bool SourceStamp::matches(const QString &path, const SourceStamp &stamp) {
+    SourceStamp current;
+    if (!statFile(path, current)) {
+        // Source isn't around (shipped without it), the baked copy is all there is
+        return true;
+    }
+    if (current.size != stamp.size) return false;
+    if (current.modified == stamp.modified) return true;
+
+    // Touched but maybe not changed (fresh checkout, copied tree), compare contents
+    quint64 hash;
+    return hashFile(path, hash) && hash == stamp.hash;
+}
@@ -0,0 +1,28 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_SOURCESTAMP_H
+#define GARDEN_SIMULATION_SOURCESTAMP_H
+
+#pragma once
+#include <QString>
+#include <QtGlobal>
+
+// Identifies the exact source file a baked/cached asset was built from
+struct SourceStamp {
+    quint64 size;
+    qint64 modified;  // ms since epoch
+    quint64 hash;     // fnv1a64 of the file contents
+
+    // Size, timestamp and content hash of path
+    static bool make(const QString &path, SourceStamp &stamp);
+
+    // True if path still has the contents stamped
+    // Timestamps are checked first, the content hash only when they differ
+    // A missing source counts as a match, the baked copy is all there is then
+    static bool matches(const QString &path, const SourceStamp &stamp);
+};
+
+
+#endif //GARDEN_SIMULATION_SOURCESTAMP_H
@@ -0,0 +1,82 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include <QDebug>
+#include <QFileInfo>
+#include "assetcache.h"
+#include "model/bakedmesh.h"
+
+AssetCache& AssetCache::instance() {
+    static AssetCache cache;
+    return cache;
+}
+
+std::shared_ptr<Mesh> AssetCache::mesh(const QString &objPath) {
+    if (std::shared_ptr<Mesh> cached = m_meshes.value(objPath).lock()) {
+        return cached;
+    }
+
+    // Either one will do, a baked mesh can ship without its OBJ
+    if (!QFileInfo::exists(objPath) && !QFileInfo::exists(BakedMesh::bakedPathFor(objPath))) {
+        qDebug() << "Asset cache: no mesh at" << objPath;
+        m_meshes.remove(objPath);
+        return nullptr;
+    }
+
+    auto mesh = std::make_shared<Mesh>(objPath);
+    m_loader.requestMesh(mesh);
+
+    m_meshes.insert(objPath, mesh);
+    qDebug() << "Asset cache: queued mesh" << objPath << "live meshes:" << liveMeshCount();
+    return mesh;
+}
+
+std::shared_ptr<Texture> AssetCache::texture(const QString &path) {
+    if (std::shared_ptr<Texture> cached = m_textures.value(path).lock()) {
+        return cached;
+    }
+
+    if (!QFileInfo::exists(path)) {
+        qDebug() << "Asset cache: no texture at" << path;
+        m_textures.remove(path);
+        return nullptr;
+    }
+
+    auto texture = std::make_shared<Texture>(path);
+    m_loader.requestTexture(texture);
+
+    m_textures.insert(path, texture);
+    qDebug() << "Asset cache: queued texture" << path << "live textures:" << liveTextureCount();
+    return texture;
+}
+
+Mesh* AssetCache::placeholderBox() {
+    // Only try once, if it failed there's no point retrying every draw
+    if (!m_placeholderTried) {
+        m_placeholderTried = true;
+        m_placeholderBox = Mesh::createPlaceholderBox();
+    }
+    return m_placeholderBox.get();
+}
+
+void AssetCache::releasePlaceholder() {
+    m_placeholderBox.reset();
+    m_placeholderTried = false;
+}
+
+int AssetCache::liveMeshCount() const {
+    int count = 0;
+    for (const auto &entry : m_meshes) {
+        if (!entry.expired()) ++count;
+    }
+    return count;
+}
+
+int AssetCache::liveTextureCount() const {
+    int count = 0;
+    for (const auto &entry : m_textures) {
+        if (!entry.expired()) ++count;
+    }
+    return count;
+}
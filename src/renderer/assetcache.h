@@ -0,0 +1,63 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_ASSETCACHE_H
+#define GARDEN_SIMULATION_ASSETCACHE_H
+
+#pragma once
+#include <QHash>
+#include <QString>
+#include <memory>
+#include "renderer/assetloader.h"
+#include "renderer/mesh.h"
+#include "renderer/texture.h"
+
+// Reference counted cache of GPU assets keyed by file path
+// The cache only holds weak references, so a mesh or texture is released as soon as
+// the last Model using it goes away and reloaded the next time it's asked for
+// Loading is asynchronous: mesh() and texture() hand back an asset in its loading state
+// right away, and it becomes resident once processUploads gets to it on the GL thread
+// Only call from the GUI thread
+class AssetCache {
+
+public:
+    static AssetCache& instance();
+
+    // Returns the shared mesh for an OBJ file, queuing the load on first use
+    // Null only if there's nothing on disk to load
+    std::shared_ptr<Mesh> mesh(const QString &objPath);
+
+    // Returns the shared texture for an image file, queuing the load on first use
+    std::shared_ptr<Texture> texture(const QString &path);
+
+    // Call once per frame with the context current, see AssetLoader::processUploads
+    int processUploads(qint64 budgetNs) { return m_loader.processUploads(budgetNs); }
+
+    // Connect to its assetStaged signal to repaint when there's something to upload
+    AssetLoader& loader() { return m_loader; }
+
+    // Stand in geometry for meshes still loading, created on first use (needs the context current)
+    Mesh* placeholderBox();
+
+    // Deletes the placeholder's GL objects, call with the context current before it goes away
+    // The cache itself lives until static destruction, when no context is left to delete them in
+    // The next placeholderBox() builds a new one
+    void releasePlaceholder();
+
+    int liveMeshCount() const;
+    int liveTextureCount() const;
+
+private:
+    AssetCache() = default;
+
+    QHash<QString, std::weak_ptr<Mesh>> m_meshes;
+    QHash<QString, std::weak_ptr<Texture>> m_textures;
+
+    AssetLoader m_loader;
+    std::unique_ptr<Mesh> m_placeholderBox;
+    bool m_placeholderTried = false;
+};
+
+
+#endif //GARDEN_SIMULATION_ASSETCACHE_H
@@ -0,0 +1,182 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QOpenGLContext>
+#include <QThread>
+#include "assetloader.h"
+
+AssetLoader::AssetLoader(QObject *parent) : QObject(parent) {
+    // Leave a core for the GUI thread
+    m_pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+}
+
+AssetLoader::~AssetLoader() {
+    // Workers only touch the staging queues, so they just have to finish before those go away
+    // The pixel buffer is left to the context, there isn't one current at shutdown
+    m_pool.waitForDone();
+}
+
+void AssetLoader::requestMesh(const std::shared_ptr<Mesh> &mesh) {
+    // Workers only ever see a weak pointer, the Mesh (and its GL objects) is only destroyed on the GL thread
+    std::weak_ptr<Mesh> weak = mesh;
+    QString path = mesh->getPath();
+
+    beginRequest();
+
+    m_pool.start([this, weak, path]() {
+        auto payload = std::make_unique<MeshPayload>();
+        bool ok = Mesh::loadData(path, *payload);
+
+        {
+            QMutexLocker lock(&m_mutex);
+            m_stagedMeshes.push_back({weak, std::move(payload), ok});
+            --m_inFlight;
+        }
+        emit assetStaged();
+    });
+}
+
+void AssetLoader::requestTexture(const std::shared_ptr<Texture> &texture) {
+    std::weak_ptr<Texture> weak = texture;
+    QString path = texture->getPath();
+
+    detectCompression();
+    CompressionSupport compression = m_compression;
+
+    beginRequest();
+
+    m_pool.start([this, weak, path, compression]() {
+        auto payload = std::make_unique<TexturePayload>();
+        bool ok = Texture::loadData(path, *payload, compression);
+
+        {
+            QMutexLocker lock(&m_mutex);
+            m_stagedTextures.push_back({weak, std::move(payload), ok});
+            --m_inFlight;
+        }
+        emit assetStaged();
+    });
+}
+
+void AssetLoader::beginRequest() {
+    QMutexLocker lock(&m_mutex);
+    if (m_batchCount == 0) {
+        m_batchTimer.start();
+    }
+    ++m_batchCount;
+    ++m_inFlight;
+}
+
+void AssetLoader::detectCompression() {
+    // Textures are requested from Mesh::upload so a context is normally current, if not the
+    // uncompressed path is always safe and the next request tries again
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    if (m_compressionKnown || !context) return;
+
+    QSurfaceFormat format = context->format();
+    m_compression.s3tc = context->hasExtension("GL_EXT_texture_compression_s3tc");
+    m_compression.rgtc = format.version() >= qMakePair(3, 0) ||
+                         context->hasExtension("GL_ARB_texture_compression_rgtc");
+    m_compressionKnown = true;
+
+    qDebug() << "Asset loader: S3TC" << (m_compression.s3tc ? "yes" : "no")
+             << "RGTC" << (m_compression.rgtc ? "yes" : "no");
+}
+
+void AssetLoader::initializeGL() {
+    if (m_glInitialized) return;
+    initializeOpenGLFunctions();
+    glGenBuffers(1, &m_pixelBuffer);
+    m_glInitialized = true;
+}
+
+int AssetLoader::processUploads(qint64 budgetNs) {
+    QElapsedTimer timer;
+    timer.start();
+
+    {
+        // Bounds are cheap to hand over, so everything staged gets its placeholder this frame
+        // even if the upload itself has to wait for a later one
+        QMutexLocker lock(&m_mutex);
+        if (m_stagedMeshes.empty() && m_stagedTextures.empty()) {
+            return 0;
+        }
+        for (const StagedMesh &staged : m_stagedMeshes) {
+            std::shared_ptr<Mesh> mesh = staged.mesh.lock();
+            if (mesh && staged.ok) {
+                mesh->setPendingBounds(staged.payload->data.boundsMin, staged.payload->data.boundsMax);
+            }
+        }
+    }
+
+    initializeGL();
+
+    int uploaded = 0;
+    while (uploaded == 0 || timer.nsecsElapsed() < budgetNs) {
+        if (!uploadNext()) break;
+        ++uploaded;
+    }
+
+    QMutexLocker lock(&m_mutex);
+    int remaining = int(m_stagedMeshes.size() + m_stagedTextures.size());
+    if (uploaded > 0) {
+        qDebug() << "Asset loader: uploaded" << uploaded << "assets in" << timer.nsecsElapsed() / 1000
+                 << "us," << remaining << "staged," << m_inFlight << "loading";
+    }
+    if (remaining == 0 && m_inFlight == 0 && m_batchCount > 0) {
+        qDebug() << "Asset loader:" << m_batchCount << "assets resident" << m_batchTimer.elapsed()
+                 << "ms after the first request, texture cache"
+                 << (BakedTexture::isEnabled() ? "on" : "off (GARDEN_NO_TEXTURE_CACHE)");
+        m_batchCount = 0;
+    }
+    return remaining;
+}
+
+bool AssetLoader::uploadNext() {
+    StagedMesh stagedMesh;
+    StagedTexture stagedTexture;
+    bool isMesh = false;
+
+    {
+        // Geometry before textures, an untextured mesh looks closer to right than a box
+        QMutexLocker lock(&m_mutex);
+        if (!m_stagedMeshes.empty()) {
+            stagedMesh = std::move(m_stagedMeshes.front());
+            m_stagedMeshes.pop_front();
+            isMesh = true;
+        } else if (!m_stagedTextures.empty()) {
+            stagedTexture = std::move(m_stagedTextures.front());
+            m_stagedTextures.pop_front();
+        } else {
+            return false;
+        }
+    }
+
+    if (isMesh) {
+        std::shared_ptr<Mesh> mesh = stagedMesh.mesh.lock();
+        if (!mesh) return true;  // every model using it went away while it loaded
+
+        if (!stagedMesh.ok || !mesh->upload(*stagedMesh.payload)) {
+            qDebug() << "Failed to load mesh:" << mesh->getPath();
+            mesh->markFailed();
+        }
+        return true;
+    }
+
+    std::shared_ptr<Texture> texture = stagedTexture.texture.lock();
+    if (!texture) return true;
+
+    if (!stagedTexture.ok || !texture->upload(*stagedTexture.payload, m_pixelBuffer)) {
+        qDebug() << "Failed to load texture:" << texture->getPath();
+    }
+    return true;
+}
+
+bool AssetLoader::isBusy() const {
+    QMutexLocker lock(&m_mutex);
+    return m_inFlight > 0 || !m_stagedMeshes.empty() || !m_stagedTextures.empty();
+}
@@ -0,0 +1,84 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_ASSETLOADER_H
+#define GARDEN_SIMULATION_ASSETLOADER_H
+
+#pragma once
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QObject>
+#include <QThreadPool>
+#include <QOpenGLFunctions_3_3_Core>
+#include <deque>
+#include <memory>
+#include "renderer/mesh.h"
+#include "renderer/texture.h"
+
+// Background loading for meshes and textures
+// Worker threads do the file reading, parsing and image decoding, and leave the results
+// staged here. The GL thread drains the staging queue with processUploads, a few assets per
+// frame so a big texture doesn't turn into a dropped frame.
+class AssetLoader : public QObject, protected QOpenGLFunctions_3_3_Core {
+Q_OBJECT
+
+public:
+    explicit AssetLoader(QObject *parent = nullptr);
+    ~AssetLoader() override;
+
+    // Queue the CPU side of loading, the asset stays in its loading state until uploaded
+    void requestMesh(const std::shared_ptr<Mesh> &mesh);
+    void requestTexture(const std::shared_ptr<Texture> &texture);
+
+    // Uploads staged assets until budgetNs is spent, at least one per call so loading
+    // always progresses. Needs the GL context current. Returns how many are still staged
+    int processUploads(qint64 budgetNs);
+
+    // Anything still on a worker or waiting for upload
+    bool isBusy() const;
+
+signals:
+    // Emitted from a worker thread when something is ready to upload, connect with a queued connection
+    void assetStaged();
+
+private:
+    struct StagedMesh {
+        std::weak_ptr<Mesh> mesh;
+        std::unique_ptr<MeshPayload> payload;
+        bool ok;
+    };
+
+    struct StagedTexture {
+        std::weak_ptr<Texture> texture;
+        std::unique_ptr<TexturePayload> payload;
+        bool ok;
+    };
+
+    QThreadPool m_pool;
+
+    mutable QMutex m_mutex;
+    std::deque<StagedMesh> m_stagedMeshes;
+    std::deque<StagedTexture> m_stagedTextures;
+    int m_inFlight = 0;
+
+    // Times each burst of loading from first request to everything resident, startup is the first
+    QElapsedTimer m_batchTimer;
+    int m_batchCount = 0;
+
+    // One unpack buffer reused (orphaned) for every texture upload
+    GLuint m_pixelBuffer = 0;
+    bool m_glInitialized = false;
+
+    // Decides whether workers may pick block compressed textures, read from the context once
+    CompressionSupport m_compression;
+    bool m_compressionKnown = false;
+
+    void initializeGL();
+    void detectCompression();
+    bool uploadNext();
+    void beginRequest();
+};
+
+
+#endif //GARDEN_SIMULATION_ASSETLOADER_H
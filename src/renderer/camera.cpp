@@ -2,8 +2,16 @@
 // Created by Raphael Russo on 1/2/25.
 //
 
+#include <atomic>
 #include "camera.h"
 
+namespace {
+
+// Shared by every camera, so a version never means two different ones
+std::atomic<quint64> nextVersion{1};
+
+}
+
 Camera::Camera(float aspectRatio)
         : m_up(0.0f, 1.0f, 0.0f)
         , m_fov(45.0f)
@@ -13,6 +21,7 @@ Camera::Camera(float aspectRatio)
         , m_distance(15.0f)
         , m_phi(M_PI / 4.0f)
         , m_theta(M_PI / 4.0f)
+        , m_version(nextVersion++)
 {
     // Set target to center of grid
     m_target = QVector3D(5.0f, 0.0f, 5.0f);  // Center of 10x10 grid
@@ -28,20 +37,72 @@ void Camera::updatePosition() {
 
     // Update camera position relative to target
     m_position = m_target + QVector3D(x, y, z);
+    changed();
 }
 
-QMatrix4x4 Camera::getViewMatrix() const {
-    // Create view matrix for world space to camera space
-    QMatrix4x4 view;
-    view.lookAt(m_position, m_target, m_up); // Position and orient camera
-    return view;
+void Camera::updateOrbit() {
+    // Inverse of updatePosition, so orbit/zoom carry on from wherever the camera was put
+    QVector3D offset = m_position - m_target;
+    float distance = offset.length();
+    if (distance <= 0.0f) return;  // on top of the target, keep the old angles
+
+    m_distance = distance;
+    m_theta = qAsin(qBound(-1.0f, offset.y() / distance, 1.0f));
+    m_phi = qAtan2(offset.z(), offset.x());
 }
 
-QMatrix4x4 Camera::getProjectionMatrix() const {
+void Camera::changed() {
+    m_version = nextVersion++;
+}
+
+void Camera::updateMatrices() const {
+    if (m_matricesVersion == m_version) return;
+
+    // Create view matrix for world space to camera space
+    m_view.setToIdentity();
+    m_view.lookAt(m_position, m_target, m_up); // Position and orient camera
+
     // Perspective projection matrix
-    QMatrix4x4 projection;
-    projection.perspective(m_fov, m_aspectRatio, m_nearPlane, m_farPlane);
-    return projection;
+    m_projection.setToIdentity();
+    m_projection.perspective(m_fov, m_aspectRatio, m_nearPlane, m_farPlane);
+
+    m_viewProjection = m_projection * m_view;
+    m_frustum = Frustum(m_viewProjection);
+    m_matricesVersion = m_version;
+}
+
+const QMatrix4x4& Camera::getViewMatrix() const {
+    updateMatrices();
+    return m_view;
+}
+
+const QMatrix4x4& Camera::getProjectionMatrix() const {
+    updateMatrices();
+    return m_projection;
+}
+
+const QMatrix4x4& Camera::getViewProjectionMatrix() const {
+    updateMatrices();
+    return m_viewProjection;
+}
+
+const Frustum& Camera::getFrustum() const {
+    updateMatrices();
+    return m_frustum;
+}
+
+const QMatrix4x4& Camera::getInverseViewMatrix() const {
+    if (m_inversesVersion != m_version) {
+        m_inverseView = getViewMatrix().inverted();
+        m_inverseProjection = getProjectionMatrix().inverted();
+        m_inversesVersion = m_version;
+    }
+    return m_inverseView;
+}
+
+const QMatrix4x4& Camera::getInverseProjectionMatrix() const {
+    getInverseViewMatrix();  // both go together
+    return m_inverseProjection;
 }
 
 
@@ -89,21 +150,28 @@ void Camera::pan(float deltaX, float deltaY) {
     QVector3D offset = (right * -deltaX + m_up * deltaY) * panSensitivity;
     m_target += offset;
     m_position += offset;
+    changed();
 }
 
 void Camera::setAspectRatio(float ratio) {
+    if (ratio == m_aspectRatio) return;  // resizes that keep the shape
     m_aspectRatio = ratio;
+    changed();
 }
 
 void Camera::setPosition(const QVector3D &position) {
     m_position = position;
+    updateOrbit();
+    changed();
 }
 
 void Camera::setTarget(const QVector3D &target) {
     m_target = target;
+    updateOrbit();
+    changed();
 }
 
-QVector3D Camera::getPosition() {
+QVector3D Camera::getPosition() const {
     return m_position;
 }
 
@@ -7,6 +7,7 @@
 
 
 #include <QMatrix4x4>
+#include "renderer/frustum.h"
 
 class Camera {
 
@@ -14,8 +15,19 @@ public:
     Camera(float aspectRatio = 16.0f/9.0f);
     ~Camera() {}
 
-    QMatrix4x4 getViewMatrix() const; // World to camera
-    QMatrix4x4 getProjectionMatrix() const; // Perspective proj
+    // Cached, rebuilt on first use after the camera moves or the viewport changes shape
+    const QMatrix4x4& getViewMatrix() const; // World to camera
+    const QMatrix4x4& getProjectionMatrix() const; // Perspective proj
+    const QMatrix4x4& getViewProjectionMatrix() const;
+    const Frustum& getFrustum() const;
+
+    // Inverses for picking, cached separately since most frames never need them
+    const QMatrix4x4& getInverseViewMatrix() const;
+    const QMatrix4x4& getInverseProjectionMatrix() const;
+
+    // Goes up with every change to the view or projection, and no two cameras ever share one,
+    // so anything derived from the camera can be kept until this moves on
+    quint64 version() const { return m_version; }
 
     void orbit(float deltaX, float deltaY);
     void zoom(float delta);
@@ -25,7 +37,7 @@ public:
     void setPosition(const QVector3D &position);
     void setTarget(const QVector3D &target);
 
-    QVector3D getPosition();
+    QVector3D getPosition() const;
     QVector3D getTarget();
     float getDistance();
 
@@ -46,7 +58,23 @@ private:
     float m_phi; // Horizontal orbital angle
     float m_theta; // Vertical orbital angle
 
+    quint64 m_version;
+
+    // Derived state and the version it was built for
+    mutable QMatrix4x4 m_view;
+    mutable QMatrix4x4 m_projection;
+    mutable QMatrix4x4 m_viewProjection;
+    mutable Frustum m_frustum{QMatrix4x4()};
+    mutable quint64 m_matricesVersion = 0;
+
+    mutable QMatrix4x4 m_inverseView;
+    mutable QMatrix4x4 m_inverseProjection;
+    mutable quint64 m_inversesVersion = 0;
+
     void updatePosition();
+    void updateOrbit();
+    void changed();
+    void updateMatrices() const;
 };
 
 
@@ -0,0 +1,250 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include "cellrenderer.h"
+
+CellRenderer::CellRenderer(int kindCount) : m_kindCount(std::max(kindCount, 1)), m_meshes(size_t(m_kindCount)) {
+}
+
+QPoint CellRenderer::tileOf(const QPoint &cell) {
+    // Floor division so negative cells don't share tile 0
+    auto tile = [](int v) { return v >= 0 ? v / TileSize : (v - TileSize + 1) / TileSize; };
+    return QPoint(tile(cell.x()), tile(cell.y()));
+}
+
+void CellRenderer::set(const QPoint &cell, int kind, const std::shared_ptr<Mesh> &mesh, const QMatrix4x4 &transform,
+                       const QVector4D &tint) {
+    if (kind < 0 || kind >= m_kindCount || !mesh) return;
+    m_meshes[size_t(kind)] = mesh;
+
+    m_treeDirty = true;
+
+    // Same kind already there, just overwrite its slot
+    auto it = m_cells.constFind(cell);
+    if (it != m_cells.constEnd() && it.value().kind == kind) {
+        Tile &tile = *m_tiles.value(tileOf(cell));
+        tile.kinds[size_t(kind)]->batch.update(it.value().index, InstanceData(transform, tint));
+        tile.boundsDirty = true;
+        return;
+    }
+    // Before looking the tile up, removing the last instance drops the tile
+    remove(cell);
+
+    std::shared_ptr<Tile> &tile = m_tiles[tileOf(cell)];
+    if (!tile) {
+        tile = std::make_shared<Tile>();
+        tile->kinds.resize(size_t(m_kindCount));
+    }
+    tile->boundsDirty = true;
+
+    std::unique_ptr<Batch> &batch = tile->kinds[size_t(kind)];
+    if (!batch) batch = std::make_unique<Batch>();
+    int index = batch->batch.append(InstanceData(transform, tint));
+    batch->cells.push_back(cell);
+    ++tile->instanceCount;
+    m_cells.insert(cell, {kind, index});
+}
+
+void CellRenderer::remove(const QPoint &cell) {
+    auto it = m_cells.find(cell);
+    if (it == m_cells.end()) return;
+    Slot slot = it.value();
+    m_cells.erase(it);
+
+    QPoint tileKey = tileOf(cell);
+    Tile &tile = *m_tiles.value(tileKey);
+    Batch &batch = *tile.kinds[size_t(slot.kind)];
+
+    // Same swap as the batch, whichever instance was last now lives in the freed slot
+    batch.batch.removeAt(slot.index);
+    QPoint moved = batch.cells.back();
+    batch.cells[size_t(slot.index)] = moved;
+    batch.cells.pop_back();
+    if (moved != cell) {
+        m_cells[moved].index = slot.index;
+    }
+
+    if (--tile.instanceCount == 0) {
+        m_tiles.remove(tileKey);
+    } else {
+        tile.boundsDirty = true;
+    }
+    m_treeDirty = true;
+}
+
+void CellRenderer::clear() {
+    m_tiles.clear();
+    m_cells.clear();
+    m_nodes.clear();
+    m_root = -1;
+    m_treeDirty = true;
+}
+
+int CellRenderer::kindInstanceCount(int kind) const {
+    if (kind < 0 || kind >= m_kindCount) return 0;
+    int count = 0;
+    for (const std::shared_ptr<Tile> &tile : m_tiles) {
+        if (const Batch *batch = tile->kinds[size_t(kind)].get()) {
+            count += batch->batch.instanceCount();
+        }
+    }
+    return count;
+}
+
+void CellRenderer::updateBounds(Tile &tile) {
+    // Meshes still loading get a cell sized stand in and another go next time
+    static const Aabb standIn(QVector3D(-0.5f, 0.0f, -0.5f), QVector3D(0.5f, 1.0f, 0.5f));
+
+    tile.bounds = Aabb();
+    tile.boundsDirty = false;
+    for (size_t kind = 0; kind < tile.kinds.size(); ++kind) {
+        const Batch *batch = tile.kinds[kind].get();
+        if (!batch || batch->batch.instanceCount() == 0) continue;
+
+        const Mesh *mesh = m_meshes[kind].get();
+        Aabb local = standIn;
+        if (mesh && mesh->hasBounds()) {
+            local = Aabb(mesh->getBoundsMin(), mesh->getBoundsMax());
+        } else {
+            tile.boundsDirty = true;
+        }
+
+        for (int i = 0; i < batch->batch.instanceCount(); ++i) {
+            QMatrix4x4 transform;
+            std::memcpy(transform.data(), batch->batch.instanceAt(i).model, sizeof(float) * 16);
+            tile.bounds.expand(local.transformed(transform));
+        }
+    }
+}
+
+void CellRenderer::rebuildTree() {
+    m_nodes.clear();
+    m_root = -1;
+    if (m_tiles.isEmpty()) {
+        m_treeDirty = false;
+        return;
+    }
+
+    bool pending = false;
+    QPoint low(INT_MAX, INT_MAX), high(INT_MIN, INT_MIN);
+    for (auto it = m_tiles.begin(); it != m_tiles.end(); ++it) {
+        Tile &tile = *it.value();
+        if (tile.boundsDirty) updateBounds(tile);
+        pending = pending || tile.boundsDirty;
+        low = QPoint(std::min(low.x(), it.key().x()), std::min(low.y(), it.key().y()));
+        high = QPoint(std::max(high.x(), it.key().x()), std::max(high.y(), it.key().y()));
+    }
+
+    // Square power of two over the occupied tiles so every split is even
+    int size = 1;
+    while (low.x() + size <= high.x() || low.y() + size <= high.y()) {
+        size *= 2;
+    }
+    m_nodes.reserve(size_t(m_tiles.size()) * 2);
+    m_root = buildNode(low.x(), low.y(), size);
+
+    // Stand in bounds get redone once the meshes know theirs
+    m_treeDirty = pending;
+}
+
+int CellRenderer::buildNode(int x, int y, int size) {
+    if (size == 1) {
+        auto it = m_tiles.constFind(QPoint(x, y));
+        if (it == m_tiles.constEnd()) return -1;
+        Node leaf;
+        leaf.tile = it.value().get();
+        leaf.bounds = leaf.tile->bounds;
+        leaf.tileCount = 1;
+        leaf.instanceCount = leaf.tile->instanceCount;
+        m_nodes.push_back(leaf);
+        return int(m_nodes.size() - 1);
+    }
+
+    int half = size / 2;
+    int children[4] = {buildNode(x, y, half), buildNode(x + half, y, half),
+                       buildNode(x, y + half, half), buildNode(x + half, y + half, half)};
+
+    // A node with only one child would just be an extra test
+    int used = 0, only = -1;
+    for (int child : children) {
+        if (child >= 0) {
+            ++used;
+            only = child;
+        }
+    }
+    if (used <= 1) return only;
+
+    Node node;
+    for (int i = 0; i < 4; ++i) {
+        node.children[i] = children[i];
+        if (children[i] < 0) continue;
+        const Node &child = m_nodes[size_t(children[i])];
+        node.bounds.expand(child.bounds);
+        node.tileCount += child.tileCount;
+        node.instanceCount += child.instanceCount;
+    }
+    m_nodes.push_back(node);
+    return int(m_nodes.size() - 1);
+}
+
+void CellRenderer::submitTile(const Tile &tile, RenderQueue &queue, Shader *shader) {
+    for (size_t kind = 0; kind < tile.kinds.size(); ++kind) {
+        Batch *batch = tile.kinds[kind].get();
+        if (!batch || batch->batch.instanceCount() == 0) continue;
+
+        DrawPacket packet;
+        packet.shader = shader;
+        packet.mesh = m_meshes[kind].get();
+        packet.batch = &batch->batch;
+        queue.submit(packet);
+    }
+}
+
+void CellRenderer::submit(RenderQueue &queue, Shader *shader) {
+    for (const std::shared_ptr<Tile> &tile : m_tiles) {
+        submitTile(*tile, queue, shader);
+    }
+}
+
+void CellRenderer::submit(RenderQueue &queue, Shader *shader, const Frustum &frustum, CullStats &stats) {
+    if (m_treeDirty) rebuildTree();
+    if (m_root >= 0) cullNode(m_root, frustum, queue, shader, stats);
+}
+
+void CellRenderer::submitSubtree(int index, RenderQueue &queue, Shader *shader, CullStats &stats) {
+    const Node &node = m_nodes[size_t(index)];
+    if (node.tile) {
+        ++stats.tilesVisible;
+        stats.instancesVisible += node.tile->instanceCount;
+        submitTile(*node.tile, queue, shader);
+        return;
+    }
+    for (int child : node.children) {
+        if (child >= 0) submitSubtree(child, queue, shader, stats);
+    }
+}
+
+void CellRenderer::cullNode(int index, const Frustum &frustum, RenderQueue &queue, Shader *shader,
+                            CullStats &stats) {
+    const Node &node = m_nodes[size_t(index)];
+    ++stats.nodesVisited;
+
+    Frustum::Result result = frustum.classify(node.bounds);
+    if (result == Frustum::Result::Outside) {
+        stats.tilesCulled += node.tileCount;
+        stats.instancesCulled += node.instanceCount;
+        return;
+    }
+    if (result == Frustum::Result::Inside || node.tile) {
+        // Everything below is in, no need to test it
+        submitSubtree(index, queue, shader, stats);
+        return;
+    }
+    for (int child : node.children) {
+        if (child >= 0) cullNode(child, frustum, queue, shader, stats);
+    }
+}
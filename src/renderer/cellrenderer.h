@@ -0,0 +1,103 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_CELLRENDERER_H
+#define GARDEN_SIMULATION_CELLRENDERER_H
+
+#pragma once
+#include <QHash>
+#include <QMatrix4x4>
+#include <QPoint>
+#include <QVector4D>
+#include <memory>
+#include <vector>
+#include "renderer/frustum.h"
+#include "renderer/instancebatch.h"
+#include "renderer/renderqueue.h"
+
+// What the last culled submit(s) looked at and threw away
+struct CullStats {
+    int nodesVisited = 0;
+    int tilesVisible = 0;
+    int tilesCulled = 0;
+    int instancesVisible = 0;
+    int instancesCulled = 0;
+};
+
+// Instanced draws of things that sit on grid cells (beds, plants), one per kind of mesh
+// The grid is cut into TileSize x TileSize tiles, each with its own InstanceBatch per kind, and a
+// quadtree over the tiles' bounds throws whole tiles away against the camera frustum, so zooming
+// into a corner of a big garden only submits the tiles around it
+// Edits are swap removes/appends in one tile's batch like before, the tile's bounds and the tree
+// are redone lazily on the next submit
+class CellRenderer {
+
+public:
+    static constexpr int TileSize = 32;  // cells per tile side, trades draw calls against culling
+
+    explicit CellRenderer(int kindCount);
+
+    // Replaces whatever was in the cell, every instance of a kind shares the mesh
+    void set(const QPoint &cell, int kind, const std::shared_ptr<Mesh> &mesh, const QMatrix4x4 &transform,
+             const QVector4D &tint = QVector4D(1.0f, 1.0f, 1.0f, 1.0f));
+    void remove(const QPoint &cell);
+    void clear();
+
+    // Every tile, no culling
+    void submit(RenderQueue &queue, Shader *shader);
+
+    // Only tiles that touch the frustum, stats are added to
+    void submit(RenderQueue &queue, Shader *shader, const Frustum &frustum, CullStats &stats);
+
+    int instanceCount() const { return int(m_cells.size()); }
+    int kindInstanceCount(int kind) const;
+    int tileCount() const { return int(m_tiles.size()); }
+
+private:
+    struct Batch {
+        InstanceBatch batch;
+        std::vector<QPoint> cells;  // cells[i] is the instance in slot i
+    };
+
+    struct Tile {
+        std::vector<std::unique_ptr<Batch>> kinds;
+        Aabb bounds;
+        int instanceCount = 0;
+        bool boundsDirty = true;
+    };
+
+    struct Slot {
+        int kind;
+        int index;
+    };
+
+    // Flattened quadtree, leaves point at a tile
+    struct Node {
+        Aabb bounds;
+        int children[4] = {-1, -1, -1, -1};
+        Tile *tile = nullptr;
+        int tileCount = 0;      // totals below this node, for the stats when it's culled
+        int instanceCount = 0;
+    };
+
+    int m_kindCount;
+    std::vector<std::shared_ptr<Mesh>> m_meshes;  // per kind
+    QHash<QPoint, std::shared_ptr<Tile>> m_tiles;
+    QHash<QPoint, Slot> m_cells;
+
+    std::vector<Node> m_nodes;
+    int m_root = -1;
+    bool m_treeDirty = true;
+
+    static QPoint tileOf(const QPoint &cell);
+    void updateBounds(Tile &tile);
+    void rebuildTree();
+    int buildNode(int x, int y, int size);
+    void submitTile(const Tile &tile, RenderQueue &queue, Shader *shader);
+    void submitSubtree(int node, RenderQueue &queue, Shader *shader, CullStats &stats);
+    void cullNode(int node, const Frustum &frustum, RenderQueue &queue, Shader *shader, CullStats &stats);
+};
+
+
+#endif //GARDEN_SIMULATION_CELLRENDERER_H
@@ -0,0 +1,219 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include <QFile>
+#include <QTextStream>
+#include <algorithm>
+#include <cmath>
+#include "frameprofiler.h"
+
+namespace {
+
+FrameProfiler::Percentiles percentilesOf(std::vector<float> &values) {
+    FrameProfiler::Percentiles result;
+    result.samples = int(values.size());
+    if (values.empty()) return result;
+
+    // Nearest rank
+    std::sort(values.begin(), values.end());
+    auto rank = [&values](double p) {
+        size_t index = size_t(std::ceil(p * double(values.size()))) - 1;
+        return double(values[std::min(index, values.size() - 1)]);
+    };
+    result.p50 = rank(0.50);
+    result.p95 = rank(0.95);
+    result.p99 = rank(0.99);
+    return result;
+}
+
+}
+
+const char* FrameProfiler::sectionName(Section section) {
+    switch (section) {
+        case Frame: return "frame";
+        case Lights: return "lights";
+        case Grid: return "grid";
+        case Sun: return "sun";
+        case Beds: return "beds";
+        case Plants: return "plants";
+        case Preview: return "preview";
+        case Highlight: return "highlight";
+        default: return "unknown";
+    }
+}
+
+FrameProfiler::~FrameProfiler() {
+    if (!m_glInitialized) return;
+    for (Slot &slot : m_slots) {
+        if (!slot.queries.empty()) glDeleteQueries(GLsizei(slot.queries.size()), slot.queries.data());
+    }
+}
+
+void FrameProfiler::setEnabled(bool enabled) {
+    // Frames from before it was turned off would land in the new run's history
+    if (enabled && !m_enabled) dropPending();
+    m_enabled = enabled;
+}
+
+void FrameProfiler::clear() {
+    dropPending();
+    m_history.clear();
+    m_droppedFrames = 0;
+}
+
+void FrameProfiler::dropPending() {
+    // The queries just get reused, whatever they still hold is never read
+    for (Slot &pending : m_slots) {
+        pending.pending = false;
+    }
+}
+
+void FrameProfiler::timestamp(Slot &slot) {
+    if (slot.usedQueries == int(slot.queries.size())) {
+        // A few more than last time, the pool settles after the first frames
+        size_t grown = slot.queries.size() + 8;
+        size_t first = slot.queries.size();
+        slot.queries.resize(grown);
+        glGenQueries(GLsizei(grown - first), slot.queries.data() + first);
+    }
+    glQueryCounter(slot.queries[size_t(slot.usedQueries++)], GL_TIMESTAMP);
+}
+
+bool FrameProfiler::resolve(Slot &slot, bool wait) {
+    // Counters land in order, so the last one being ready means they all are
+    if (!wait) {
+        GLint available = 0;
+        glGetQueryObjectiv(slot.queries[size_t(slot.usedQueries - 1)], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) return false;
+    }
+
+    std::vector<GLuint64> stamps(size_t(slot.usedQueries));
+    for (int i = 0; i < slot.usedQueries; ++i) {
+        glGetQueryObjectui64v(slot.queries[size_t(i)], GL_QUERY_RESULT, &stamps[size_t(i)]);
+    }
+
+    // The frame's own counters are the first and last, runs are pairs in between
+    FrameRecord &record = slot.record;
+    record.gpuMs.fill(-1.0f);
+    record.gpuMs[Frame] = float((stamps.back() - stamps.front()) / 1e6);
+    for (const Run &run : slot.runs) {
+        float ms = float((stamps[size_t(run.startQuery) + 1] - stamps[size_t(run.startQuery)]) / 1e6);
+        float &total = record.gpuMs[run.section];
+        total = total < 0.0f ? ms : total + ms;
+    }
+
+    m_history.push_back(record);
+    if (int(m_history.size()) > HistorySize) m_history.pop_front();
+    return true;
+}
+
+void FrameProfiler::beginFrame() {
+    if (!m_enabled) return;
+    if (!m_glInitialized) {
+        initializeOpenGLFunctions();
+        m_glInitialized = true;
+    }
+
+    // Pick up whatever finished, oldest first, this frame's slot has to be free either way
+    for (int i = 1; i <= SlotCount; ++i) {
+        Slot &pending = m_slots[size_t((m_current + i) % SlotCount)];
+        if (pending.pending && resolve(pending)) pending.pending = false;
+    }
+    m_current = (m_current + 1) % SlotCount;
+    Slot &current = slot();
+    if (current.pending) {
+        ++m_droppedFrames;  // GPU is SlotCount frames behind, not worth waiting for
+        current.pending = false;
+    }
+
+    current.usedQueries = 0;
+    current.runs.clear();
+    current.record.frame = m_frameNumber++;
+    current.record.cpuMs.fill(-1.0f);
+    m_open = SectionCount;
+    m_inFrame = true;
+    m_frameTimer.start();
+    timestamp(current);
+}
+
+void FrameProfiler::begin(Section section) {
+    if (!m_inFrame) return;
+    end();
+
+    Slot &current = slot();
+    current.runs.push_back({section, current.usedQueries});
+    timestamp(current);
+    m_open = section;
+    m_sectionTimer.start();
+}
+
+void FrameProfiler::end() {
+    if (!m_inFrame || m_open == SectionCount) return;
+
+    Slot &current = slot();
+    float ms = float(m_sectionTimer.nsecsElapsed() / 1e6);
+    float &total = current.record.cpuMs[m_open];
+    total = total < 0.0f ? ms : total + ms;
+    timestamp(current);
+    m_open = SectionCount;
+}
+
+void FrameProfiler::endFrame() {
+    if (!m_inFrame) return;
+    end();
+
+    Slot &current = slot();
+    current.record.cpuMs[Frame] = float(m_frameTimer.nsecsElapsed() / 1e6);
+    timestamp(current);
+    current.pending = true;
+    m_inFrame = false;
+}
+
+void FrameProfiler::collect() {
+    if (!m_glInitialized) return;
+    for (int i = 1; i <= SlotCount; ++i) {
+        Slot &pending = m_slots[size_t((m_current + i) % SlotCount)];
+        if (pending.pending) {
+            resolve(pending, true);
+            pending.pending = false;
+        }
+    }
+}
+
+FrameProfiler::Summary FrameProfiler::summary() const {
+    Summary summary;
+    summary.frames = int(m_history.size());
+    summary.droppedFrames = m_droppedFrames;
+
+    std::vector<float> cpu, gpu;
+    cpu.reserve(m_history.size());
+    gpu.reserve(m_history.size());
+    for (int section = 0; section < SectionCount; ++section) {
+        cpu.clear();
+        gpu.clear();
+        for (const FrameRecord &record : m_history) {
+            if (record.cpuMs[size_t(section)] >= 0.0f) cpu.push_back(record.cpuMs[size_t(section)]);
+            if (record.gpuMs[size_t(section)] >= 0.0f) gpu.push_back(record.gpuMs[size_t(section)]);
+        }
+        summary.cpu[size_t(section)] = percentilesOf(cpu);
+        summary.gpu[size_t(section)] = percentilesOf(gpu);
+    }
+    return summary;
+}
+
+bool FrameProfiler::writeCsv(const QString &path) const {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+
+    QTextStream out(&file);
+    out << "frame,section,cpu_ms,gpu_ms\n";
+    for (const FrameRecord &record : m_history) {
+        for (int section = 0; section < SectionCount; ++section) {
+            if (record.cpuMs[size_t(section)] < 0.0f && record.gpuMs[size_t(section)] < 0.0f) continue;
+            out << record.frame << ',' << sectionName(Section(section)) << ','
+                << record.cpuMs[size_t(section)] << ',' << record.gpuMs[size_t(section)] << '\n';
+        }
+    }
+    return out.status() == QTextStream::Ok;
+}
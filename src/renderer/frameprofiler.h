@@ -0,0 +1,124 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_FRAMEPROFILER_H
+#define GARDEN_SIMULATION_FRAMEPROFILER_H
+
+#pragma once
+#include <QElapsedTimer>
+#include <QOpenGLFunctions_3_3_Core>
+#include <QString>
+#include <array>
+#include <deque>
+#include <vector>
+
+// CPU and GPU time per render pass over the last HistorySize frames, with percentiles and CSV export
+// Sections don't nest, begin closes whichever one is open, and a section can run several times in a
+// frame (the render queue switches back and forth), the runs add up. GPU times come from GL_TIMESTAMP
+// counters at each run's ends, those nest fine inside the frame's own GL_TIME_ELAPSED (GpuTimer).
+// A frame's counters are read SlotCount frames later, only if they're ready, so it never stalls;
+// frames whose results aren't back by then are dropped from the history
+// Off until setEnabled, then the context has to be current between beginFrame and endFrame
+class FrameProfiler : protected QOpenGLFunctions_3_3_Core {
+
+public:
+    enum Section : int {
+        Frame,      // the whole render
+        Lights,     // cluster assignment and upload
+        Grid,
+        Sun,
+        Beds,
+        Plants,
+        Preview,    // drag preview
+        Highlight,  // delete mode hover
+        SectionCount
+    };
+    static const char* sectionName(Section section);
+
+    // Frames kept for the percentiles and the CSV, about 10 seconds at 60 Hz
+    static constexpr int HistorySize = 600;
+
+    struct Percentiles {
+        double p50 = 0.0;
+        double p95 = 0.0;
+        double p99 = 0.0;
+        int samples = 0;  // frames the section ran in
+    };
+    struct Summary {
+        std::array<Percentiles, SectionCount> cpu;
+        std::array<Percentiles, SectionCount> gpu;
+        int frames = 0;
+        int droppedFrames = 0;
+    };
+
+    FrameProfiler() = default;
+    ~FrameProfiler();
+
+    FrameProfiler(const FrameProfiler&) = delete;
+    FrameProfiler& operator=(const FrameProfiler&) = delete;
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_enabled; }
+
+    void beginFrame();
+    void endFrame();
+    void begin(Section section);
+    void end();
+
+    // Reads back every frame still waiting on the GPU, blocking, for the end of an offline run
+    // Turning the profiler back on or clearing it throws those frames away instead
+    void collect();
+
+    Summary summary() const;
+    void clear();
+
+    // One row per section per frame: frame,section,cpu_ms,gpu_ms
+    bool writeCsv(const QString &path) const;
+
+private:
+    static constexpr int SlotCount = 3;
+
+    // Milliseconds per section, negative when the section didn't run that frame
+    struct FrameRecord {
+        quint64 frame = 0;
+        std::array<float, SectionCount> cpuMs;
+        std::array<float, SectionCount> gpuMs;
+    };
+
+    struct Run {
+        Section section;
+        int startQuery;  // index into the slot's queries
+    };
+
+    // One frame's counters waiting for the GPU
+    struct Slot {
+        std::vector<GLuint> queries;
+        int usedQueries = 0;
+        std::vector<Run> runs;
+        FrameRecord record;
+        bool pending = false;
+    };
+
+    bool m_enabled = false;
+    bool m_glInitialized = false;
+    bool m_inFrame = false;
+    std::array<Slot, SlotCount> m_slots;
+    int m_current = 0;
+    quint64 m_frameNumber = 0;
+
+    Section m_open = SectionCount;  // SectionCount when none is
+    QElapsedTimer m_sectionTimer;
+    QElapsedTimer m_frameTimer;
+
+    std::deque<FrameRecord> m_history;
+    int m_droppedFrames = 0;
+
+    Slot& slot() { return m_slots[size_t(m_current)]; }
+    void timestamp(Slot &slot);
+    bool resolve(Slot &slot, bool wait = false);
+    void dropPending();
+};
+
+
+#endif //GARDEN_SIMULATION_FRAMEPROFILER_H
@@ -0,0 +1,74 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include <algorithm>
+#include "frustum.h"
+
+void Aabb::expand(const QVector3D &point) {
+    min = QVector3D(std::min(min.x(), point.x()), std::min(min.y(), point.y()), std::min(min.z(), point.z()));
+    max = QVector3D(std::max(max.x(), point.x()), std::max(max.y(), point.y()), std::max(max.z(), point.z()));
+}
+
+void Aabb::expand(const Aabb &box) {
+    if (box.isEmpty()) return;
+    expand(box.min);
+    expand(box.max);
+}
+
+Aabb Aabb::transformed(const QMatrix4x4 &transform) const {
+    if (isEmpty()) return *this;
+
+    // Arvo: each output axis is the translation plus the min/max of every column's contribution
+    const float *m = transform.constData();  // column major
+    float outMin[3], outMax[3];
+    for (int row = 0; row < 3; ++row) {
+        outMin[row] = outMax[row] = m[12 + row];
+        for (int column = 0; column < 3; ++column) {
+            float a = m[column * 4 + row] * min[column];
+            float b = m[column * 4 + row] * max[column];
+            outMin[row] += std::min(a, b);
+            outMax[row] += std::max(a, b);
+        }
+    }
+    return {QVector3D(outMin[0], outMin[1], outMin[2]), QVector3D(outMax[0], outMax[1], outMax[2])};
+}
+
+Frustum::Frustum(const QMatrix4x4 &viewProjection) {
+    // Gribb/Hartmann, each plane is the last row plus or minus one of the others
+    QVector4D rows[4];
+    for (int i = 0; i < 4; ++i) {
+        rows[i] = viewProjection.row(i);
+    }
+    m_planes = {rows[3] + rows[0], rows[3] - rows[0],   // left, right
+                rows[3] + rows[1], rows[3] - rows[1],   // bottom, top
+                rows[3] + rows[2], rows[3] - rows[2]};  // near, far
+
+    for (QVector4D &plane : m_planes) {
+        float length = plane.toVector3D().length();
+        if (length > 0.0f) plane /= length;
+    }
+}
+
+Frustum::Result Frustum::classify(const Aabb &box) const {
+    if (box.isEmpty()) return Result::Outside;
+
+    Result result = Result::Inside;
+    for (const QVector4D &plane : m_planes) {
+        // The corner furthest along the normal decides outside, the nearest one decides straddling
+        QVector3D farCorner(plane.x() >= 0.0f ? box.max.x() : box.min.x(),
+                            plane.y() >= 0.0f ? box.max.y() : box.min.y(),
+                            plane.z() >= 0.0f ? box.max.z() : box.min.z());
+        QVector3D nearCorner(plane.x() >= 0.0f ? box.min.x() : box.max.x(),
+                             plane.y() >= 0.0f ? box.min.y() : box.max.y(),
+                             plane.z() >= 0.0f ? box.min.z() : box.max.z());
+
+        if (QVector3D::dotProduct(plane.toVector3D(), farCorner) + plane.w() < 0.0f) {
+            return Result::Outside;
+        }
+        if (QVector3D::dotProduct(plane.toVector3D(), nearCorner) + plane.w() < 0.0f) {
+            result = Result::Intersects;
+        }
+    }
+    return result;
+}
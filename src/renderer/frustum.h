@@ -0,0 +1,50 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_FRUSTUM_H
+#define GARDEN_SIMULATION_FRUSTUM_H
+
+#pragma once
+#include <QMatrix4x4>
+#include <QVector3D>
+#include <QVector4D>
+#include <array>
+
+// Axis aligned box, starts out empty so expanding it with the first point/box just takes that
+struct Aabb {
+    QVector3D min = QVector3D(1e30f, 1e30f, 1e30f);
+    QVector3D max = QVector3D(-1e30f, -1e30f, -1e30f);
+
+    Aabb() = default;
+    Aabb(const QVector3D &boxMin, const QVector3D &boxMax) : min(boxMin), max(boxMax) {}
+
+    bool isEmpty() const { return min.x() > max.x(); }
+    void expand(const QVector3D &point);
+    void expand(const Aabb &box);
+
+    // Smallest box around this one after transform, without going through all 8 corners
+    Aabb transformed(const QMatrix4x4 &transform) const;
+};
+
+// Six planes pulled out of a view-projection matrix, normals point inwards
+class Frustum {
+
+public:
+    enum class Result {
+        Outside,
+        Intersects,
+        Inside
+    };
+
+    explicit Frustum(const QMatrix4x4 &viewProjection);
+
+    Result classify(const Aabb &box) const;
+    bool isVisible(const Aabb &box) const { return classify(box) != Result::Outside; }
+
+private:
+    std::array<QVector4D, 6> m_planes;
+};
+
+
+#endif //GARDEN_SIMULATION_FRUSTUM_H
@@ -0,0 +1,180 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include "glstatecache.h"
+
+GLStateCache& GLStateCache::instance() {
+    // Never destroyed, meshes and textures held by AssetCache still call in while statics go away
+    static GLStateCache *cache = new GLStateCache;
+    cache->initialize();
+    return *cache;
+}
+
+void GLStateCache::initialize() {
+    // Without a context current this fails, so stay uninitialized and try again next time
+    if (m_initialized || !initializeOpenGLFunctions()) return;
+    m_initialized = true;
+    invalidate();
+}
+
+void GLStateCache::invalidate() {
+    m_program = Unknown;
+    m_vao = Unknown;
+    m_activeUnit = Unknown;
+    m_textures.fill(Unknown);
+    m_textureBuffers.fill(Unknown);
+    m_uniformBuffers.fill(Unknown);
+    m_uniformOffsets.fill(-1);
+    m_depthFunc = Unknown;
+    m_depthMask = -1;
+    m_blend = -1;
+}
+
+bool GLStateCache::changed(GLuint &shadow, GLuint value) {
+    if (shadow == value) {
+        ++m_stats.skipped;
+        return false;
+    }
+    shadow = value;
+    ++m_stats.issued;
+    return true;
+}
+
+void GLStateCache::useProgram(GLuint program) {
+    if (changed(m_program, program)) {
+        glUseProgram(program);
+    }
+}
+
+void GLStateCache::bindVertexArray(GLuint vao) {
+    if (changed(m_vao, vao)) {
+        glBindVertexArray(vao);
+    }
+}
+
+void GLStateCache::bindTexture(GLuint unit, GLuint texture) {
+    if (unit >= GLuint(TextureUnits)) {
+        // Past what's shadowed, always goes through and leaves the active unit unknown
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        m_activeUnit = Unknown;
+        ++m_stats.issued;
+        return;
+    }
+
+    if (m_textures[unit] == texture) {
+        ++m_stats.skipped;
+        return;
+    }
+    // The active unit only matters when something actually gets bound
+    if (changed(m_activeUnit, unit)) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+    }
+    changed(m_textures[unit], texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+void GLStateCache::bindTextureBuffer(GLuint unit, GLuint texture) {
+    if (unit >= GLuint(TextureUnits)) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_BUFFER, texture);
+        m_activeUnit = Unknown;
+        ++m_stats.issued;
+        return;
+    }
+
+    if (m_textureBuffers[unit] == texture) {
+        ++m_stats.skipped;
+        return;
+    }
+    if (changed(m_activeUnit, unit)) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+    }
+    changed(m_textureBuffers[unit], texture);
+    glBindTexture(GL_TEXTURE_BUFFER, texture);
+}
+
+void GLStateCache::bindUniformBuffer(GLuint binding, GLuint buffer) {
+    if (binding >= GLuint(UniformBindings)) {
+        glBindBufferBase(GL_UNIFORM_BUFFER, binding, buffer);
+        ++m_stats.issued;
+        return;
+    }
+    if (m_uniformOffsets[binding] != -1) {
+        m_uniformBuffers[binding] = Unknown;
+        m_uniformOffsets[binding] = -1;
+    }
+    if (changed(m_uniformBuffers[binding], buffer)) {
+        glBindBufferBase(GL_UNIFORM_BUFFER, binding, buffer);
+    }
+}
+
+void GLStateCache::bindUniformBufferRange(GLuint binding, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+    if (binding >= GLuint(UniformBindings)) {
+        glBindBufferRange(GL_UNIFORM_BUFFER, binding, buffer, offset, size);
+        ++m_stats.issued;
+        return;
+    }
+    // The size never changes for a binding, buffer and offset are enough to tell
+    if (m_uniformBuffers[binding] == buffer && m_uniformOffsets[binding] == offset) {
+        ++m_stats.skipped;
+        return;
+    }
+    m_uniformBuffers[binding] = buffer;
+    m_uniformOffsets[binding] = offset;
+    ++m_stats.issued;
+    glBindBufferRange(GL_UNIFORM_BUFFER, binding, buffer, offset, size);
+}
+
+void GLStateCache::forgetTexture(GLuint texture) {
+    for (GLuint &bound : m_textures) {
+        if (bound == texture) bound = 0;
+    }
+    for (GLuint &bound : m_textureBuffers) {
+        if (bound == texture) bound = 0;
+    }
+}
+
+void GLStateCache::forgetVertexArray(GLuint vao) {
+    if (m_vao == vao) m_vao = 0;
+}
+
+void GLStateCache::forgetUniformBuffer(GLuint buffer) {
+    for (int i = 0; i < UniformBindings; ++i) {
+        if (m_uniformBuffers[size_t(i)] == buffer) {
+            m_uniformBuffers[size_t(i)] = 0;
+            m_uniformOffsets[size_t(i)] = -1;
+        }
+    }
+}
+
+void GLStateCache::setDepthFunc(GLenum func) {
+    if (changed(m_depthFunc, func)) {
+        glDepthFunc(func);
+    }
+}
+
+void GLStateCache::setDepthMask(bool enabled) {
+    if (m_depthMask == int(enabled)) {
+        ++m_stats.skipped;
+        return;
+    }
+    m_depthMask = int(enabled);
+    ++m_stats.issued;
+    glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+}
+
+void GLStateCache::setBlend(bool enabled) {
+    if (m_blend == int(enabled)) {
+        ++m_stats.skipped;
+        return;
+    }
+    m_blend = int(enabled);
+    ++m_stats.issued;
+    if (enabled) {
+        glEnable(GL_BLEND);
+    } else {
+        glDisable(GL_BLEND);
+    }
+}
@@ -0,0 +1,82 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_GLSTATECACHE_H
+#define GARDEN_SIMULATION_GLSTATECACHE_H
+
+#pragma once
+#include <QOpenGLFunctions_3_3_Core>
+#include <array>
+
+// Shadow copy of the GL binds the renderer changes, so setting what's already set never reaches GL
+// and nothing ever has to be read back with glGet*. Only works if every bind of the tracked state
+// goes through here, anything that can't (Qt between frames) is covered by invalidate
+// One per process like AssetCache, there's only the one GL context
+class GLStateCache : protected QOpenGLFunctions_3_3_Core {
+
+public:
+    // Binds issued to GL versus dropped because the state was already there
+    struct Stats {
+        int issued = 0;
+        int skipped = 0;
+    };
+
+    static GLStateCache& instance();
+
+    GLStateCache(const GLStateCache&) = delete;
+    GLStateCache& operator=(const GLStateCache&) = delete;
+
+    // Forgets everything, the next set of each state always goes to GL
+    // Call at the start of a frame, Qt may have touched state since the last one
+    void invalidate();
+
+    void useProgram(GLuint program);
+    void bindVertexArray(GLuint vao);
+    void bindTexture(GLuint unit, GLuint texture);  // GL_TEXTURE_2D on that unit
+    void bindTextureBuffer(GLuint unit, GLuint texture);  // GL_TEXTURE_BUFFER on that unit
+    void bindUniformBuffer(GLuint binding, GLuint buffer);
+    void bindUniformBufferRange(GLuint binding, GLuint buffer, GLintptr offset, GLsizeiptr size);
+
+    // GL drops the binding of a deleted object back to 0, and the name can come back from glGen*,
+    // so owners call these before deleting
+    void forgetTexture(GLuint texture);
+    void forgetVertexArray(GLuint vao);
+    void forgetUniformBuffer(GLuint buffer);
+
+    void setDepthFunc(GLenum func);
+    void setDepthMask(bool enabled);
+    void setBlend(bool enabled);
+
+    const Stats& stats() const { return m_stats; }
+    void resetStats() { m_stats = Stats(); }
+
+private:
+    static constexpr GLuint Unknown = 0xFFFFFFFFu;
+    static constexpr int TextureUnits = 16;
+    static constexpr int UniformBindings = 8;
+
+    GLStateCache() = default;
+
+    GLuint m_program = Unknown;
+    GLuint m_vao = Unknown;
+    GLuint m_activeUnit = Unknown;
+    std::array<GLuint, TextureUnits> m_textures{};
+    std::array<GLuint, TextureUnits> m_textureBuffers{};
+    std::array<GLuint, UniformBindings> m_uniformBuffers{};
+    std::array<GLintptr, UniformBindings> m_uniformOffsets{};  // -1 for the whole buffer
+    GLenum m_depthFunc = Unknown;
+    int m_depthMask = -1;  // -1 unknown
+    int m_blend = -1;
+
+    Stats m_stats;
+    bool m_initialized = false;
+
+    void initialize();
+
+    // True when value differs from shadow (and updates it), counts either way
+    bool changed(GLuint &shadow, GLuint value);
+};
+
+
+#endif //GARDEN_SIMULATION_GLSTATECACHE_H
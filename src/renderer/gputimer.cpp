@@ -0,0 +1,55 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include "gputimer.h"
+
+GpuTimer::~GpuTimer() {
+    if (m_glInitialized) glDeleteQueries(QueryCount, m_queries.data());
+}
+
+void GpuTimer::begin() {
+    if (!m_glInitialized) {
+        initializeOpenGLFunctions();
+        glGenQueries(QueryCount, m_queries.data());
+        m_glInitialized = true;
+    }
+
+    collect();
+    m_active = -1;
+    if (m_inFlight[size_t(m_next)]) return;  // GPU is more than QueryCount frames behind
+
+    m_active = m_next;
+    glBeginQuery(GL_TIME_ELAPSED, m_queries[size_t(m_active)]);
+}
+
+void GpuTimer::end() {
+    if (m_active < 0) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    m_inFlight[size_t(m_active)] = true;
+    m_next = (m_active + 1) % QueryCount;
+    m_active = -1;
+}
+
+void GpuTimer::collect() {
+    // Oldest first, they finish in order
+    for (int i = 0; i < QueryCount; ++i) {
+        size_t slot = size_t((m_next + i) % QueryCount);
+        if (!m_inFlight[slot]) continue;
+
+        GLint available = 0;
+        glGetQueryObjectiv(m_queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) break;
+
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(m_queries[slot], GL_QUERY_RESULT, &elapsed);
+        m_elapsedNs += qint64(elapsed);
+        m_inFlight[slot] = false;
+    }
+}
+
+qint64 GpuTimer::takeElapsedNs() {
+    qint64 elapsed = m_elapsedNs;
+    m_elapsedNs = 0;
+    return elapsed;
+}
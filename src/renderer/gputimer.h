@@ -0,0 +1,45 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_GPUTIMER_H
+#define GARDEN_SIMULATION_GPUTIMER_H
+
+#pragma once
+#include <QOpenGLFunctions_3_3_Core>
+#include <array>
+
+// GPU time spent between begin and end, through GL_TIME_ELAPSED queries
+// Results are read a few frames late and only once available, so it never stalls the pipeline.
+// If every query is still in flight a frame just goes untimed
+class GpuTimer : protected QOpenGLFunctions_3_3_Core {
+
+public:
+    GpuTimer() = default;
+    ~GpuTimer();
+
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    // Around the frame, needs the context current
+    void begin();
+    void end();
+
+    // GPU nanoseconds of the frames that finished since the last call
+    qint64 takeElapsedNs();
+
+private:
+    static constexpr int QueryCount = 4;
+
+    std::array<GLuint, QueryCount> m_queries{};
+    std::array<bool, QueryCount> m_inFlight{};
+    int m_next = 0;
+    int m_active = -1;  // query between begin and end, -1 when this frame isn't timed
+    qint64 m_elapsedNs = 0;
+    bool m_glInitialized = false;
+
+    void collect();
+};
+
+
+#endif //GARDEN_SIMULATION_GPUTIMER_H
@@ -0,0 +1,144 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "gridpicker.h"
+
+namespace {
+
+constexpr float Infinity = std::numeric_limits<float>::infinity();
+
+// Slab test, distances along the ray where it enters and leaves the box
+bool intersect(const PickRay &ray, const Aabb &box, float &enter, float &exit) {
+    enter = 0.0f;
+    exit = Infinity;
+    for (int axis = 0; axis < 3; ++axis) {
+        float origin = ray.origin[axis];
+        float direction = ray.direction[axis];
+        if (direction == 0.0f) {
+            if (origin < box.min[axis] || origin > box.max[axis]) return false;
+            continue;
+        }
+        float near = (box.min[axis] - origin) / direction;
+        float far = (box.max[axis] - origin) / direction;
+        if (near > far) std::swap(near, far);
+        enter = std::max(enter, near);
+        exit = std::min(exit, far);
+        if (enter > exit) return false;
+    }
+    return true;
+}
+
+}
+
+void GridPicker::setGridSize(int size) {
+    m_gridSize = std::max(0, size);
+    clearPlants();
+}
+
+void GridPicker::clearPlants() {
+    m_bounds.assign(size_t(m_gridSize) * size_t(m_gridSize), Aabb());
+    m_plantCount = 0;
+    m_extent = Aabb();
+    m_reach = 0;
+}
+
+void GridPicker::setPlantBounds(const QPoint &cell, const Aabb &bounds) {
+    if (!isInside(cell.x(), cell.y()) || bounds.isEmpty()) return;
+
+    Aabb &slot = m_bounds[size_t(cell.x()) * size_t(m_gridSize) + size_t(cell.y())];
+    if (slot.isEmpty()) ++m_plantCount;
+    slot = bounds;
+
+    m_extent.expand(bounds);
+    float overhang = std::max({float(cell.x()) - bounds.min.x(), bounds.max.x() - float(cell.x() + 1),
+                               float(cell.y()) - bounds.min.z(), bounds.max.z() - float(cell.y() + 1)});
+    m_reach = std::max(m_reach, int(std::ceil(overhang)));
+}
+
+void GridPicker::removePlant(const QPoint &cell) {
+    if (!isInside(cell.x(), cell.y())) return;
+
+    Aabb &slot = m_bounds[size_t(cell.x()) * size_t(m_gridSize) + size_t(cell.y())];
+    if (slot.isEmpty()) return;
+    slot = Aabb();
+    --m_plantCount;
+}
+
+PickRay GridPicker::screenRay(const Camera &camera, const QPointF &position, const QSize &viewport) {
+    // Normalized device coords (-1 to 1), y up
+    float x = float(2.0 * position.x() / viewport.width() - 1.0);
+    float y = float(1.0 - 2.0 * position.y() / viewport.height());
+
+    // Backwards through the pipeline, the eye space direction only needs the projection undone
+    QVector4D eye = camera.getInverseProjectionMatrix() * QVector4D(x, y, -1.0f, 1.0f);
+    eye.setZ(-1.0f);
+    eye.setW(0.0f);
+    QVector3D direction = (camera.getInverseViewMatrix() * eye).toVector3D().normalized();
+    return {camera.getPosition(), direction};
+}
+
+void GridPicker::testCells(const PickRay &ray, int x, int z, Hit &hit, float &nearest) const {
+    for (int cx = x - m_reach; cx <= x + m_reach; ++cx) {
+        for (int cz = z - m_reach; cz <= z + m_reach; ++cz) {
+            if (!isInside(cx, cz)) continue;
+            const Aabb &bounds = m_bounds[size_t(cx) * size_t(m_gridSize) + size_t(cz)];
+            float enter, exit;
+            if (bounds.isEmpty() || !intersect(ray, bounds, enter, exit) || enter >= nearest) continue;
+            nearest = enter;
+            hit.plant = QPoint(cx, cz);
+            hit.plantDistance = enter;
+        }
+    }
+}
+
+GridPicker::Hit GridPicker::pick(const PickRay &ray) const {
+    Hit hit;
+
+    // Bed: straight onto the ground plane, off the garden is a miss rather than the nearest edge cell
+    if (ray.direction.y() < 0.0f && ray.origin.y() > 0.0f) {
+        hit.ground = ray.origin + ray.direction * (-ray.origin.y() / ray.direction.y());
+        hit.hitsGround = true;
+        int x = int(std::floor(hit.ground.x()));
+        int z = int(std::floor(hit.ground.z()));
+        if (isInside(x, z)) hit.cell = QPoint(x, z);
+    }
+
+    // Plants: only the stretch of ray inside the space they take up
+    float enter, exit;
+    if (m_plantCount == 0 || !intersect(ray, m_extent, enter, exit)) return hit;
+
+    QVector3D start = ray.origin + ray.direction * enter;
+    int x = int(std::floor(start.x()));
+    int z = int(std::floor(start.z()));
+
+    // Amanatides & Woo, distance to the next x and z cell edge and between edges
+    float dx = ray.direction.x(), dz = ray.direction.z();
+    int stepX = dx > 0.0f ? 1 : -1;
+    int stepZ = dz > 0.0f ? 1 : -1;
+    float nextX = dx != 0.0f ? (float(x + (stepX > 0 ? 1 : 0)) - ray.origin.x()) / dx : Infinity;
+    float nextZ = dz != 0.0f ? (float(z + (stepZ > 0 ? 1 : 0)) - ray.origin.z()) / dz : Infinity;
+    float deltaX = dx != 0.0f ? 1.0f / std::abs(dx) : Infinity;
+    float deltaZ = dz != 0.0f ? 1.0f / std::abs(dz) : Infinity;
+
+    // Any box hit at distance t holds the ray point at t, and that point's cell is within m_reach of
+    // the plant's, so once the walk passes the nearest hit so far nothing closer is left
+    float nearest = Infinity;
+    float cellEnter = enter;
+    while (cellEnter <= exit && cellEnter < nearest) {
+        testCells(ray, x, z, hit, nearest);
+        if (nextX < nextZ) {
+            cellEnter = nextX;
+            nextX += deltaX;
+            x += stepX;
+        } else {
+            cellEnter = nextZ;
+            nextZ += deltaZ;
+            z += stepZ;
+        }
+    }
+    return hit;
+}
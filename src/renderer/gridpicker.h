@@ -0,0 +1,74 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_GRIDPICKER_H
+#define GARDEN_SIMULATION_GRIDPICKER_H
+
+#pragma once
+#include <QPoint>
+#include <QPointF>
+#include <QSize>
+#include <QVector3D>
+#include <vector>
+#include "renderer/camera.h"
+#include "renderer/frustum.h"
+
+// World space ray, direction normalised
+struct PickRay {
+    QVector3D origin;
+    QVector3D direction;
+};
+
+// Which bed and which plant are under the cursor, without touching the GPU
+// The ray is cut against the ground plane for the bed, and for plants it walks the cells under it
+// front to back (2D DDA over x/z) testing the boxes of plants in them, so cost follows the cells the
+// ray crosses, not the garden size. Plant boxes reaching into neighbouring cells are caught by also
+// testing the cells around each visited one, as far as the widest plant overhangs
+class GridPicker {
+
+public:
+    struct Hit {
+        QPoint cell = QPoint(-1, -1);   // bed under the ray, (-1, -1) off the garden or above the horizon
+        QVector3D ground;               // where the ray meets y = 0, only set with hitsGround
+        bool hitsGround = false;
+
+        QPoint plant = QPoint(-1, -1);  // nearest plant box the ray goes through
+        float plantDistance = 0.0f;
+
+        bool hitsPlant() const { return plant.x() >= 0; }
+
+        // What a click means: the plant if one's in the way, otherwise the bed behind
+        QPoint target() const { return hitsPlant() ? plant : cell; }
+    };
+
+    // Drops every plant, cells are 1x1 from the origin like the beds
+    void setGridSize(int size);
+    int gridSize() const { return m_gridSize; }
+
+    // World bounds of the plant in a cell, replaced if there is one already
+    void setPlantBounds(const QPoint &cell, const Aabb &bounds);
+    void removePlant(const QPoint &cell);
+    void clearPlants();
+    int plantCount() const { return m_plantCount; }
+
+    // Through a widget position, in pixels from the top left
+    static PickRay screenRay(const Camera &camera, const QPointF &position, const QSize &viewport);
+
+    Hit pick(const PickRay &ray) const;
+
+private:
+    int m_gridSize = 0;
+    std::vector<Aabb> m_bounds;  // per cell, x major, empty without a plant
+    int m_plantCount = 0;
+
+    // Everything plants take up, only ever grows until clearPlants, the walk is clipped to it
+    Aabb m_extent;
+    int m_reach = 0;  // cells the widest plant spills past its own
+
+    bool isInside(int x, int z) const { return x >= 0 && z >= 0 && x < m_gridSize && z < m_gridSize; }
+    void testCells(const PickRay &ray, int x, int z, Hit &hit, float &nearest) const;
+};
+
+
+#endif //GARDEN_SIMULATION_GRIDPICKER_H
@@ -0,0 +1,165 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include <algorithm>
+#include <cstring>
+#include "instancebatch.h"
+#include "renderer/assetcache.h"
+#include "renderer/glstatecache.h"
+#include "renderer/modeluniforms.h"
+#include "renderer/normalmatrix.h"
+
+static_assert(sizeof(InstanceData) == 116, "model.vert expects a mat4, a vec4 and a mat3 per instance");
+
+InstanceData::InstanceData(const QMatrix4x4 &matrix, const QVector4D &colour) {
+    std::memcpy(model, matrix.constData(), sizeof(model));
+    tint[0] = colour.x();
+    tint[1] = colour.y();
+    tint[2] = colour.z();
+    tint[3] = colour.w();
+    NormalMatrix::of(matrix, normal);
+}
+
+InstanceBatch::~InstanceBatch() {
+    if (m_VAO) {
+        GLStateCache::instance().forgetVertexArray(m_VAO);
+        glDeleteVertexArrays(1, &m_VAO);
+    }
+    if (m_instanceVBO) glDeleteBuffers(1, &m_instanceVBO);
+}
+
+void InstanceBatch::initializeGL() {
+    if (m_glInitialized) return;
+    initializeOpenGLFunctions();
+    glGenVertexArrays(1, &m_VAO);
+    glGenBuffers(1, &m_instanceVBO);
+    m_glInitialized = true;
+}
+
+void InstanceBatch::setInstances(const std::vector<InstanceData> &instances) {
+    m_instances = instances;
+    markDirty(0, m_instances.size());
+}
+
+int InstanceBatch::append(const InstanceData &instance) {
+    m_instances.push_back(instance);
+    markDirty(m_instances.size() - 1, m_instances.size());
+    return int(m_instances.size() - 1);
+}
+
+void InstanceBatch::removeAt(int index) {
+    if (index < 0 || size_t(index) >= m_instances.size()) return;
+
+    // The tail shrinking needs no upload, the draw count just drops
+    size_t last = m_instances.size() - 1;
+    if (size_t(index) != last) {
+        m_instances[size_t(index)] = m_instances[last];
+        markDirty(size_t(index), size_t(index) + 1);
+    }
+    m_instances.pop_back();
+    m_dirtyEnd = std::min(m_dirtyEnd, m_instances.size());
+    m_dirtyBegin = std::min(m_dirtyBegin, m_dirtyEnd);
+}
+
+void InstanceBatch::update(int index, const InstanceData &instance) {
+    if (index < 0 || size_t(index) >= m_instances.size()) return;
+    m_instances[size_t(index)] = instance;
+    markDirty(size_t(index), size_t(index) + 1);
+}
+
+void InstanceBatch::clear() {
+    m_instances.clear();
+    m_dirtyBegin = m_dirtyEnd = 0;
+}
+
+void InstanceBatch::markDirty(size_t begin, size_t end) {
+    if (m_dirtyBegin == m_dirtyEnd) {
+        m_dirtyBegin = begin;
+        m_dirtyEnd = end;
+        return;
+    }
+    m_dirtyBegin = std::min(m_dirtyBegin, begin);
+    m_dirtyEnd = std::max(m_dirtyEnd, end);
+}
+
+void InstanceBatch::flush() {
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
+    if (m_instances.size() > m_capacity) {
+        // Room to grow so adding plants one at a time doesn't reallocate every time
+        m_capacity = std::max(m_instances.size(), m_capacity * 2);
+        glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(m_capacity * sizeof(InstanceData)), nullptr, GL_DYNAMIC_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, GLsizeiptr(m_instances.size() * sizeof(InstanceData)), m_instances.data());
+    } else if (m_dirtyBegin < m_dirtyEnd) {
+        glBufferSubData(GL_ARRAY_BUFFER, GLintptr(m_dirtyBegin * sizeof(InstanceData)),
+                        GLsizeiptr((m_dirtyEnd - m_dirtyBegin) * sizeof(InstanceData)), m_instances.data() + m_dirtyBegin);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    m_dirtyBegin = m_dirtyEnd = 0;
+}
+
+void InstanceBatch::bindLayout(Mesh *source) {
+    GLStateCache::instance().bindVertexArray(m_VAO);
+    source->bindVertexLayout();
+
+    // mat4 takes four vec4 slots, all advancing once per instance
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
+    for (int column = 0; column < 4; ++column) {
+        GLuint location = GLuint(3 + column);
+        glEnableVertexAttribArray(location);
+        glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                              (void*)(offsetof(InstanceData, model) + column * 4 * sizeof(float)));
+        glVertexAttribDivisor(location, 1);
+    }
+    glEnableVertexAttribArray(7);
+    glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)offsetof(InstanceData, tint));
+    glVertexAttribDivisor(7, 1);
+
+    // mat3 normal matrix, three vec3 slots
+    for (int column = 0; column < 3; ++column) {
+        GLuint location = GLuint(8 + column);
+        glEnableVertexAttribArray(location);
+        glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                              (void*)(offsetof(InstanceData, normal) + column * 3 * sizeof(float)));
+        glVertexAttribDivisor(location, 1);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    m_layoutMesh = source;
+}
+
+bool InstanceBatch::draw(Mesh *mesh, Shader *shader) {
+    if (!mesh || m_instances.empty()) return false;
+
+    // Stand in for a mesh that's still loading, same as Mesh::draw does for one instance
+    Mesh *source = mesh;
+    if (!mesh->isResident()) {
+        if (mesh->getState() != Mesh::State::Loading || !mesh->hasBounds()) return false;
+        source = AssetCache::instance().placeholderBox();
+        if (!source || !source->isResident()) return false;
+    }
+
+    initializeGL();
+    flush();
+
+    // The VAO follows whichever mesh is drawn, so it's rebuilt once when the real one arrives
+    if (source != m_layoutMesh) {
+        bindLayout(source);
+    }
+
+    const ModelUniforms &uniforms = shader->handles<ModelUniforms>();
+    shader->bind();
+    shader->set(uniforms.instanced, true);
+    source->applyMaterial(shader);
+    if (source != mesh) {
+        // The box is a compact unit cube, stretched over the pending bounds
+        shader->set(uniforms.positionOffset, mesh->getBoundsMin());
+        shader->set(uniforms.positionScale, mesh->getBoundsMax() - mesh->getBoundsMin());
+    }
+
+    GLStateCache::instance().bindVertexArray(m_VAO);
+    glDrawElementsInstanced(GL_TRIANGLES, source->getIndexCount(), GL_UNSIGNED_INT, 0, GLsizei(m_instances.size()));
+
+    shader->set(uniforms.instanced, false);
+    return true;
+}
@@ -0,0 +1,81 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_INSTANCEBATCH_H
+#define GARDEN_SIMULATION_INSTANCEBATCH_H
+
+#pragma once
+#include <QMatrix4x4>
+#include <QOpenGLFunctions_3_3_Core>
+#include <QVector4D>
+#include <vector>
+#include "renderer/mesh.h"
+#include "renderer/shader.h"
+
+// Per instance attributes, laid out the way model.vert reads them (locations 3-10)
+struct InstanceData {
+    float model[16];  // column major, straight from QMatrix4x4::constData
+    float tint[4];    // multiplies the base colour, rgb only for now
+    float normal[9];  // mat3 normal matrix, column major (see NormalMatrix)
+
+    InstanceData(const QMatrix4x4 &matrix, const QVector4D &colour);
+};
+
+// Draws one mesh many times with a single glDrawElementsInstanced
+// Owns the instance buffer and a VAO that combines it with the mesh's vertex/index buffers,
+// the mesh itself is untouched so normal draws of it keep working
+// While the mesh is loading the placeholder box is instanced instead, sized to the mesh's bounds
+// Edits only touch a CPU copy and can happen without a context, draw uploads the range that
+// changed with one glBufferSubData (or reallocates, doubling, when the buffer is too small)
+// Destroying one deletes its GL names though, so whoever drops a batch needs the context current
+class InstanceBatch : protected QOpenGLFunctions_3_3_Core {
+
+public:
+    InstanceBatch() = default;
+    ~InstanceBatch();
+
+    InstanceBatch(const InstanceBatch&) = delete;
+    InstanceBatch& operator=(const InstanceBatch&) = delete;
+
+    // Replaces every instance
+    void setInstances(const std::vector<InstanceData> &instances);
+
+    // Adds an instance at the end, returns its index
+    int append(const InstanceData &instance);
+
+    // Swap remove, the last instance moves into index so indices past it stay put
+    void removeAt(int index);
+
+    void update(int index, const InstanceData &instance);
+    void clear();
+
+    // Sets the instanced flag and material on shader, the caller sets view/projection
+    // Returns false if there was nothing to draw
+    bool draw(Mesh *mesh, Shader *shader);
+
+    int instanceCount() const { return int(m_instances.size()); }
+    const InstanceData& instanceAt(int index) const { return m_instances[size_t(index)]; }
+    GLuint vertexArray() const { return m_VAO; }
+
+private:
+    std::vector<InstanceData> m_instances;
+
+    GLuint m_VAO = 0;
+    GLuint m_instanceVBO = 0;
+    size_t m_capacity = 0;     // instances the GL buffer has room for
+    size_t m_dirtyBegin = 0;   // [begin, end) changed since the last upload
+    size_t m_dirtyEnd = 0;
+    bool m_glInitialized = false;
+
+    // Mesh whose buffers m_VAO currently points at, only compared never dereferenced
+    const Mesh *m_layoutMesh = nullptr;
+
+    void initializeGL();
+    void markDirty(size_t begin, size_t end);
+    void flush();
+    void bindLayout(Mesh *source);
+};
+
+
+#endif //GARDEN_SIMULATION_INSTANCEBATCH_H
@@ -0,0 +1,195 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include <QElapsedTimer>
+#include <algorithm>
+#include <cmath>
+#include "lightclusters.h"
+#include "glstatecache.h"
+
+namespace {
+
+int tileOf(float ndc, int tiles) {
+    return std::clamp(int(std::floor((ndc * 0.5f + 0.5f) * float(tiles))), 0, tiles - 1);
+}
+
+}
+
+LightClusters::~LightClusters() {
+    if (!m_glInitialized) return;
+    GLStateCache &state = GLStateCache::instance();
+    state.forgetTexture(m_lightTexture);
+    state.forgetTexture(m_gridTexture);
+    glDeleteTextures(1, &m_lightTexture);
+    glDeleteTextures(1, &m_gridTexture);
+    glDeleteBuffers(1, &m_lightBuffer);
+    glDeleteBuffers(1, &m_gridBuffer);
+}
+
+void LightClusters::initializeGL() {
+    initializeOpenGLFunctions();
+    glGenBuffers(1, &m_lightBuffer);
+    glGenBuffers(1, &m_gridBuffer);
+    glGenTextures(1, &m_lightTexture);
+    glGenTextures(1, &m_gridTexture);
+    m_glInitialized = true;
+
+    // The textures follow the buffers through every re-upload, so they're attached once
+    uploadLights();
+    uploadGrid();
+    GLStateCache &state = GLStateCache::instance();
+    state.bindTextureBuffer(LightDataUnit, m_lightTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, m_lightBuffer);
+    state.bindTextureBuffer(LightGridUnit, m_gridTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, m_gridBuffer);
+}
+
+void LightClusters::setLights(const std::vector<GardenLight> &lights) {
+    m_lights = lights;
+    m_lightsDirty = true;
+}
+
+void LightClusters::update(const Camera &camera) {
+    if (!m_glInitialized) initializeGL();
+    if (m_assigned && !m_lightsDirty && camera.version() == m_cameraVersion) return;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // Near and far straight from the perspective matrix
+    const QMatrix4x4 &projection = camera.getProjectionMatrix();
+    float nearPlane = projection(2, 3) / (projection(2, 2) - 1.0f);
+    float farPlane = projection(2, 3) / (projection(2, 2) + 1.0f);
+    m_view = camera.getViewMatrix();
+    m_projection = projection;
+    m_cameraVersion = camera.version();
+    assign(nearPlane, std::min(farPlane, ClusterFar));
+
+    if (m_lightsDirty) uploadLights();
+    uploadGrid();
+    m_lightsDirty = false;
+    m_assigned = true;
+    m_stats.assignNs = timer.nsecsElapsed();
+}
+
+void LightClusters::assign(float nearPlane, float farPlane) {
+    // slice = log(depth / near) / log(far / near) * Slices, as a scale and bias on log(depth)
+    float logRange = std::log(farPlane / nearPlane);
+    m_sliceScale = float(Slices) / logRange;
+    m_sliceBias = -float(Slices) * std::log(nearPlane) / logRange;
+    auto sliceOf = [this](float depth) {
+        return std::clamp(int(std::floor(std::log(depth) * m_sliceScale + m_sliceBias)), 0, Slices - 1);
+    };
+
+    m_stats = Stats();
+    m_stats.lights = int(m_lights.size());
+    m_counts.assign(ClusterCount, 0);
+    m_ranges.resize(m_lights.size());
+
+    // First pass, the clusters each light's bounds cover and how many lights every cluster gets
+    for (size_t i = 0; i < m_lights.size(); ++i) {
+        const GardenLight &light = m_lights[i];
+        Range &range = m_ranges[i];
+        range.x0 = 1;
+        range.x1 = 0;
+
+        QVector3D centre = m_view.map(light.position);
+        float radius = light.radius;
+        float nearest = -centre.z() - radius;
+        float farthest = -centre.z() + radius;
+        if (farthest <= nearPlane || radius <= 0.0f) continue;  // behind the camera
+        nearest = std::max(nearest, nearPlane);
+
+        // Screen bounds of the view space box around the sphere, cut at the near plane so
+        // the corners never go behind the camera
+        float minX = 1.0f, maxX = -1.0f, minY = 1.0f, maxY = -1.0f;
+        bool first = true;
+        for (float depth : {nearest, farthest}) {
+            for (float dx : {-radius, radius}) {
+                for (float dy : {-radius, radius}) {
+                    QVector3D ndc = m_projection.map(QVector3D(centre.x() + dx, centre.y() + dy, -depth));
+                    minX = first ? ndc.x() : std::min(minX, ndc.x());
+                    maxX = first ? ndc.x() : std::max(maxX, ndc.x());
+                    minY = first ? ndc.y() : std::min(minY, ndc.y());
+                    maxY = first ? ndc.y() : std::max(maxY, ndc.y());
+                    first = false;
+                }
+            }
+        }
+        if (maxX < -1.0f || minX > 1.0f || maxY < -1.0f || minY > 1.0f) continue;  // off screen
+
+        range = {tileOf(minX, TilesX), tileOf(maxX, TilesX), tileOf(minY, TilesY), tileOf(maxY, TilesY),
+                 sliceOf(nearest), sliceOf(farthest)};
+        ++m_stats.visibleLights;
+        for (int z = range.z0; z <= range.z1; ++z) {
+            for (int y = range.y0; y <= range.y1; ++y) {
+                for (int x = range.x0; x <= range.x1; ++x) {
+                    ++m_counts[size_t((z * TilesY + y) * TilesX + x)];
+                }
+            }
+        }
+    }
+
+    // Offsets past the (offset, count) header, capped lists
+    m_grid.assign(size_t(ClusterCount) * 2, 0);
+    quint32 offset = quint32(ClusterCount) * 2;
+    for (int cluster = 0; cluster < ClusterCount; ++cluster) {
+        quint32 count = std::min(m_counts[size_t(cluster)], quint32(MaxLightsPerCluster));
+        m_stats.dropped += int(m_counts[size_t(cluster)] - count);
+        m_stats.busiestCluster = std::max(m_stats.busiestCluster, int(m_counts[size_t(cluster)]));
+        m_grid[size_t(cluster) * 2] = offset;
+        m_counts[size_t(cluster)] = 0;  // reused as the fill cursor
+        offset += count;
+    }
+    m_grid.resize(offset);
+    m_stats.assignments = int(offset) - ClusterCount * 2;
+
+    // Second pass fills the lists in light order
+    for (size_t i = 0; i < m_lights.size(); ++i) {
+        const Range &range = m_ranges[i];
+        if (range.x0 > range.x1) continue;
+        for (int z = range.z0; z <= range.z1; ++z) {
+            for (int y = range.y0; y <= range.y1; ++y) {
+                for (int x = range.x0; x <= range.x1; ++x) {
+                    size_t cluster = size_t((z * TilesY + y) * TilesX + x);
+                    quint32 &filled = m_counts[cluster];
+                    if (filled == quint32(MaxLightsPerCluster)) continue;
+                    m_grid[m_grid[cluster * 2] + filled] = quint32(i);
+                    m_grid[cluster * 2 + 1] = ++filled;
+                }
+            }
+        }
+    }
+}
+
+void LightClusters::uploadLights() {
+    std::vector<float> data;
+    data.reserve(m_lights.size() * 8);
+    for (const GardenLight &light : m_lights) {
+        QVector3D color = light.color * light.intensity;
+        data.insert(data.end(), {light.position.x(), light.position.y(), light.position.z(), light.radius,
+                                 color.x(), color.y(), color.z(), 0.0f});
+    }
+    if (data.empty()) data.resize(8, 0.0f);  // a texture buffer needs some storage behind it
+
+    // Whole new storage each time, the old one is freed once the GPU is done with it
+    glBindBuffer(GL_TEXTURE_BUFFER, m_lightBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, GLsizeiptr(data.size() * sizeof(float)), data.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void LightClusters::uploadGrid() {
+    if (m_grid.empty()) m_grid.assign(size_t(ClusterCount) * 2, 0);
+
+    glBindBuffer(GL_TEXTURE_BUFFER, m_gridBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, GLsizeiptr(m_grid.size() * sizeof(quint32)), m_grid.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void LightClusters::bind() {
+    if (!m_glInitialized) initializeGL();
+    GLStateCache &state = GLStateCache::instance();
+    state.bindTextureBuffer(LightDataUnit, m_lightTexture);
+    state.bindTextureBuffer(LightGridUnit, m_gridTexture);
+}
@@ -0,0 +1,107 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_LIGHTCLUSTERS_H
+#define GARDEN_SIMULATION_LIGHTCLUSTERS_H
+
+#pragma once
+#include <QMatrix4x4>
+#include <QOpenGLFunctions_3_3_Core>
+#include <QVector4D>
+#include <vector>
+#include "model/gardenlight.h"
+#include "renderer/camera.h"
+
+// Clustered forward shading for the garden's point lights
+// The view frustum is cut into TilesX x TilesY screen tiles and Slices depth slices (log spaced, so
+// near clusters stay small), every light goes into the clusters its sphere's bounds touch, and
+// model.frag only loops over its own cluster's list. Lights and lists go to the GPU as texture buffers:
+//   lightData  RGBA32F, per light (position, radius) then (colour * intensity, 0)
+//   lightGrid  R32UI, per cluster (offset, count) then the light indices the offsets point into
+// Needs the context current for update, bind and the destructor
+class LightClusters : protected QOpenGLFunctions_3_3_Core {
+
+public:
+    // Same sizes as the constants in model.frag
+    static constexpr int TilesX = 16;
+    static constexpr int TilesY = 9;
+    static constexpr int Slices = 24;
+    static constexpr int ClusterCount = TilesX * TilesY * Slices;
+
+    // Caps the fragment loop, lights past it in a crowded cluster are dropped (and counted)
+    static constexpr int MaxLightsPerCluster = 64;
+
+    // Depth the slices stop at, everything past it shares the last one
+    static constexpr float ClusterFar = 100.0f;
+
+    // Units past any a mesh binds its textures on
+    static constexpr GLuint LightDataUnit = 14;
+    static constexpr GLuint LightGridUnit = 15;
+
+    struct Stats {
+        int lights = 0;
+        int visibleLights = 0;       // in front of the camera and on screen
+        int assignments = 0;         // light indices over every cluster
+        int busiestCluster = 0;
+        int dropped = 0;             // over MaxLightsPerCluster
+        qint64 assignNs = 0;
+    };
+
+    LightClusters() = default;
+    ~LightClusters();
+
+    LightClusters(const LightClusters&) = delete;
+    LightClusters& operator=(const LightClusters&) = delete;
+
+    // World space, re-uploaded on the next update
+    void setLights(const std::vector<GardenLight> &lights);
+    int lightCount() const { return int(m_lights.size()); }
+
+    // Assigns the lights to this view's clusters and uploads the lists, skipped when neither the
+    // camera's version nor the lights changed since the last call
+    void update(const Camera &camera);
+
+    // Texture buffers on LightDataUnit and LightGridUnit
+    void bind();
+
+    // Frame block clusters vector: log depth scale and bias for the slice, light count
+    QVector4D frameParameters() const { return QVector4D(m_sliceScale, m_sliceBias, float(m_lights.size()), 0.0f); }
+
+    // Stats of the last assignment that ran
+    const Stats& stats() const { return m_stats; }
+
+    // The lightGrid contents, for checking the assignment without a GPU
+    const std::vector<quint32>& grid() const { return m_grid; }
+
+private:
+    std::vector<GardenLight> m_lights;
+    std::vector<quint32> m_grid;
+    std::vector<quint32> m_counts;  // per cluster, reused between updates
+
+    // Per light cluster range from the first pass, empty (x0 > x1) when it isn't visible
+    struct Range {
+        int x0, x1, y0, y1, z0, z1;
+    };
+    std::vector<Range> m_ranges;
+
+    QMatrix4x4 m_view, m_projection;
+    quint64 m_cameraVersion = 0;
+    float m_sliceScale = 0.0f;
+    float m_sliceBias = 0.0f;
+    bool m_lightsDirty = true;
+    bool m_assigned = false;
+    Stats m_stats;
+
+    GLuint m_lightBuffer = 0, m_lightTexture = 0;
+    GLuint m_gridBuffer = 0, m_gridTexture = 0;
+    bool m_glInitialized = false;
+
+    void initializeGL();
+    void assign(float nearPlane, float farPlane);
+    void uploadLights();
+    void uploadGrid();
+};
+
+
+#endif //GARDEN_SIMULATION_LIGHTCLUSTERS_H
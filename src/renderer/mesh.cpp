@@ -0,0 +1,438 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include "mesh.h"
+#include "model/bakedmesh.h"
+#include "model/meshoptimizer.h"
+#include "model/objparser.h"
+#include "renderer/assetcache.h"
+#include "renderer/glstatecache.h"
+#include "renderer/lightclusters.h"
+#include "renderer/modeluniforms.h"
+#include "renderer/uniformblocks.h"
+
+
+namespace {
+
+// Grey stand in for meshes that aren't resident yet
+Material placeholderMaterial() {
+    Material material;
+    material.ambient = QVector3D(0.2f, 0.2f, 0.2f);
+    material.diffuse = QVector3D(0.55f, 0.55f, 0.5f);
+    material.specular = QVector3D(0.0f, 0.0f, 0.0f);
+    return material;
+}
+
+}
+
+Mesh::Mesh(const QString &objPath) : m_path(objPath), m_VAO(0), m_VBO(0), m_EBO(0), m_materialUBO(0), m_indexCount(0),
+                                     m_format(VertexFormat::Full), m_state(State::Loading),
+                                     m_hasBounds(false) {
+    // GL functions are resolved in upload, a Mesh can be created before the context is current
+}
+
+Mesh::~Mesh() {
+    // Never uploaded (still loading, or failed), so there's nothing for GL to delete
+    if (!m_VAO && !m_VBO && !m_EBO && !m_materialUBO) return;
+
+    GLStateCache &state = GLStateCache::instance();
+    if (m_VAO) {
+        state.forgetVertexArray(m_VAO);
+        glDeleteVertexArrays(1, &m_VAO);
+    }
+    if (m_VBO) glDeleteBuffers(1, &m_VBO);
+    if (m_EBO) glDeleteBuffers(1, &m_EBO);
+    if (m_materialUBO) {
+        state.forgetUniformBuffer(m_materialUBO);
+        glDeleteBuffers(1, &m_materialUBO);
+    }
+}
+
+bool Mesh::load() {
+    MeshPayload payload;
+    if (!loadData(m_path, payload) || !upload(payload)) {
+        m_state = State::Failed;
+        return false;
+    }
+    return true;
+}
+
+bool Mesh::loadData(const QString &objPath, MeshPayload &payload) {
+    // Baked mesh first, the OBJ is only parsed when there's no baked copy or it's stale
+    if (loadBaked(objPath, payload)) {
+        return true;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    MeshData &data = payload.data;
+    ObjParser parser;
+    if (!parser.parse(objPath, data)) {
+        qDebug() << "Failed to parse OBJ file:" << parser.getError();
+        return false;
+    }
+
+    qDebug() << "Parsed" << objPath << "in" << timer.nsecsElapsed() / 1000 << "us,"
+             << data.vertices.size() << "unique vertices for" << data.sourceCornerCount << "corners,"
+             << "dedup ratio" << data.compressionRatio();
+
+    // Baked meshes already went through this, only the OBJ fallback pays for it here
+    MeshOptimizer::Report report = MeshOptimizer::optimize(data);
+    qDebug() << "Vertex cache ACMR" << report.before.acmr << "->" << report.after.acmr
+             << "ATVR" << report.before.atvr << "->" << report.after.atvr;
+
+    // Half the vertex size when the mesh survives quantization, full floats otherwise
+    QuantizationError error;
+    bool isCompact = VertexQuantizer::tryQuantize(data, payload.compactVertices, error);
+    qDebug() << (isCompact ? "Using compact vertices," : "Keeping full vertices,")
+             << "quantization error position" << error.position
+             << "normal" << error.normalDegrees << "deg uv" << error.texCoord;
+    if (isCompact) {
+        data.vertices.clear();
+        data.vertices.shrink_to_fit();
+    }
+    return true;
+}
+
+bool Mesh::loadBaked(const QString &objPath, MeshPayload &payload) {
+    QElapsedTimer timer;
+    timer.start();
+
+    auto baked = std::make_unique<BakedMesh>();
+    QString bakedPath = BakedMesh::bakedPathFor(objPath);
+    if (!baked->open(bakedPath)) {
+        return false;
+    }
+    if (!baked->isUpToDate(objPath)) {
+        qDebug() << "Baked mesh is stale, falling back to OBJ:" << bakedPath;
+        return false;
+    }
+
+    // Only the material and bounds are copied, the arrays stay in the mapping until upload
+    baked->readMeshInfo(payload.data);
+    payload.baked = std::move(baked);
+
+    qDebug() << "Mapped baked mesh" << bakedPath << "in" << timer.nsecsElapsed() / 1000 << "us";
+    return true;
+}
+
+bool Mesh::upload(const MeshPayload &payload) {
+    bool ok;
+    const MeshData &data = payload.data;
+    if (const BakedMesh *baked = payload.baked.get()) {
+        // Vertex/index data goes to the GL straight out of the mapping, in whatever format it was baked
+        ok = baked->vertexFormat() == VertexFormat::Compact
+             ? upload(data, baked->compactVertices(), baked->vertexCount(), baked->indices(), baked->indexCount())
+             : upload(data, baked->vertices(), baked->vertexCount(), baked->indices(), baked->indexCount());
+    } else if (!payload.compactVertices.empty()) {
+        ok = upload(data, payload.compactVertices.data(), payload.compactVertices.size(),
+                    data.indices.data(), data.indices.size());
+    } else {
+        ok = upload(data);
+    }
+
+    if (!ok) {
+        m_state = State::Failed;
+    }
+    return ok;
+}
+
+bool Mesh::upload(const MeshData &data) {
+    return upload(data, data.vertices.data(), data.vertices.size(), data.indices.data(), data.indices.size());
+}
+
+bool Mesh::upload(const MeshData &info, const Vertex *vertices, size_t vertexCount,
+                  const unsigned int *indices, size_t indexCount) {
+    return uploadVertices(info, VertexFormat::Full, vertices, vertexCount, indices, indexCount);
+}
+
+bool Mesh::upload(const MeshData &info, const CompactVertex *vertices, size_t vertexCount,
+                  const unsigned int *indices, size_t indexCount) {
+    return uploadVertices(info, VertexFormat::Compact, vertices, vertexCount, indices, indexCount);
+}
+
+bool Mesh::uploadVertices(const MeshData &info, VertexFormat format, const void *vertices, size_t vertexCount,
+                          const unsigned int *indices, size_t indexCount) {
+    if (indexCount == 0) {
+        qDebug() << "Mesh has no faces:" << m_path;
+        return false;
+    }
+
+    QOpenGLFunctions_3_3_Core::initializeOpenGLFunctions();
+
+    m_format = format;
+    m_material = info.material;
+    m_boundsMin = info.boundsMin;
+    m_boundsMax = info.boundsMax;
+    m_hasBounds = true;
+
+    loadTextures();
+    setupMesh(vertices, vertexCount, indices, indexCount);
+
+    if (m_keepGeometry) {
+        // Whatever format it was uploaded in, the kept copy is full floats
+        m_keptVertices.clear();
+        if (format == VertexFormat::Compact) {
+            const auto *compact = static_cast<const CompactVertex*>(vertices);
+            m_keptVertices.reserve(vertexCount);
+            for (size_t i = 0; i < vertexCount; ++i) {
+                m_keptVertices.push_back(VertexQuantizer::dequantize(compact[i], info.boundsMin, info.boundsMax));
+            }
+        } else {
+            const auto *full = static_cast<const Vertex*>(vertices);
+            m_keptVertices.assign(full, full + vertexCount);
+        }
+        m_keptIndices.assign(indices, indices + indexCount);
+    }
+
+    // The material never changes after upload, so its block is written once
+    MaterialBlock block(m_material);
+    glGenBuffers(1, &m_materialUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_materialUBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(block), &block, GL_STATIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    m_state = State::Resident;
+
+    QVector3D dimensions = m_boundsMax - m_boundsMin;
+    QVector3D center     = (m_boundsMin + m_boundsMax) * 0.5f;
+
+    qDebug() << "Model dimensions:" << dimensions;
+    qDebug() << "Model center:"     << center;
+
+    return true;
+}
+
+void Mesh::loadTextures() {
+    m_textures.clear();
+
+    // Textures are shared through the cache, meshes using the same image upload it once
+    // They stream in after the mesh, until then the flat material colour is used
+    if (!m_material.diffuseMap.isEmpty()) {
+        std::shared_ptr<Texture> texture = AssetCache::instance().texture(m_material.diffuseMap);
+        if (texture) {
+            m_textures.push_back({texture, "diffuse"});
+            qDebug() << "Requested diffuse texture:" << m_material.diffuseMap;
+        } else {
+            qDebug() << "Failed to load diffuse texture:" << m_material.diffuseMap;
+        }
+    }
+
+    if (!m_material.normalMap.isEmpty()) {
+        std::shared_ptr<Texture> texture = AssetCache::instance().texture(m_material.normalMap);
+        if (texture) {
+            m_textures.push_back({texture, "normal"});
+            qDebug() << "Requested normal map:" << m_material.normalMap
+                     << "with bump multiplier:" << m_material.bumpMultiplier;
+        } else {
+            qDebug() << "Failed to load normal map:" << m_material.normalMap;
+        }
+    }
+}
+
+void Mesh::setupMesh(const void *vertices, size_t vertexCount,
+                     const unsigned int *indices, size_t indexCount) {
+    bool compact = m_format == VertexFormat::Compact;
+    size_t stride = compact ? sizeof(CompactVertex) : sizeof(Vertex);
+
+    // Create buffers/arrays
+    glGenVertexArrays(1, &m_VAO);
+    glGenBuffers(1, &m_VBO);
+    glGenBuffers(1, &m_EBO);
+
+    // The element buffer bind below lands in whatever VAO is bound, so the cache has to know
+    GLStateCache &state = GLStateCache::instance();
+    state.bindVertexArray(m_VAO);
+
+    // Load data into vertex buffer
+    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertexCount * stride,
+                 vertices, GL_STATIC_DRAW);
+
+    // Load data into element buffer
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(unsigned int),
+                 indices, GL_STATIC_DRAW);
+    m_indexCount = GLsizei(indexCount);
+
+    bindVertexLayout();
+    state.bindVertexArray(0);
+}
+
+void Mesh::bindVertexLayout() {
+    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+
+    if (m_format == VertexFormat::Compact) {
+        // Same locations, normalized integers and halfs, model.vert decodes them
+        // Position, unorm16 in the mesh bounds
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(CompactVertex),
+                              (void*)offsetof(CompactVertex, position));
+
+        // Normal, octahedral snorm16 (z comes through as 0)
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(CompactVertex),
+                              (void*)offsetof(CompactVertex, normal));
+
+        // TexCoords
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(CompactVertex),
+                              (void*)offsetof(CompactVertex, texCoords));
+        return;
+    }
+
+    // Set vertex attribute pointers
+    // Position
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                          (void*)offsetof(Vertex, position));
+
+    // Normal
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                          (void*)offsetof(Vertex, normal));
+
+    // TexCoords
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                          (void*)offsetof(Vertex, texCoords));
+}
+
+void Mesh::draw(Shader* shader) {
+    if (m_state != State::Resident) {
+        drawPlaceholder(shader);
+        return;
+    }
+
+    applyMaterial(shader);
+
+    // Draw mesh, binds stay as they are for whatever draws next
+    GLStateCache::instance().bindVertexArray(m_VAO);
+    glDrawElements(GL_TRIANGLES, m_indexCount, GL_UNSIGNED_INT, 0);
+}
+
+GLuint Mesh::materialKey() const {
+    // The diffuse texture is the expensive bind, meshes without one sort by their material block
+    for (const TextureSlot &slot : m_textures) {
+        if (slot.type == "diffuse" && slot.texture->isValid()) return slot.texture->getId();
+    }
+    return m_materialUBO;
+}
+
+void Mesh::applyMaterial(Shader *shader) {
+    const ModelUniforms &uniforms = shader->handles<ModelUniforms>();
+
+    GLStateCache &state = GLStateCache::instance();
+
+    // Material properties come from this mesh's block
+    state.bindUniformBuffer(MaterialBlockBinding, m_materialUBO);
+
+    // Handle textures
+    bool hasDiffuse = false;
+    bool hasNormal = false;
+
+    for (unsigned int i = 0; i < m_textures.size(); i++) {
+        if (!m_textures[i].texture->isValid()) continue;  // still loading
+
+        const QString &name = m_textures[i].type;
+        if (name == "diffuse") {
+            hasDiffuse = true;
+            shader->set(uniforms.diffuseMap, int(i));  // Diffuse map
+        }
+        else if (name == "normal") {
+            hasNormal = true;
+            shader->set(uniforms.normalMap, int(i));   // Normal map
+        }
+
+        // Bind the texture, a no-op when the last mesh used the same one
+        state.bindTexture(i, m_textures[i].texture->getId());
+    }
+
+
+    shader->set(uniforms.hasDiffuseMap, hasDiffuse);
+    shader->set(uniforms.hasNormalMap, hasNormal);
+
+    // Point light buffers live on their own units, left at 0 they'd clash with diffuseMap's type
+    shader->set(uniforms.lightData, int(LightClusters::LightDataUnit));
+    shader->set(uniforms.lightGrid, int(LightClusters::LightGridUnit));
+
+    // Compact positions are relative to the bounds they were quantized in
+    shader->set(uniforms.compactVertices, m_format == VertexFormat::Compact);
+    shader->set(uniforms.positionOffset, m_boundsMin);
+    shader->set(uniforms.positionScale, m_boundsMax - m_boundsMin);
+}
+
+void Mesh::setPendingBounds(const QVector3D &boundsMin, const QVector3D &boundsMax) {
+    if (m_state != State::Loading) return;
+    m_boundsMin = boundsMin;
+    m_boundsMax = boundsMax;
+    m_hasBounds = true;
+}
+
+void Mesh::drawPlaceholder(Shader *shader) {
+    // Nothing to size the box with until a loader thread has read the file
+    if (m_state != State::Loading || !m_hasBounds) return;
+
+    Mesh *box = AssetCache::instance().placeholderBox();
+    if (!box || !box->isResident()) return;
+
+    // The box is a compact unit cube, so stretching it over our bounds is just the decode uniforms
+    const ModelUniforms &uniforms = shader->handles<ModelUniforms>();
+    box->applyMaterial(shader);
+    shader->set(uniforms.positionOffset, m_boundsMin);
+    shader->set(uniforms.positionScale, m_boundsMax - m_boundsMin);
+
+    // Through the box's GL functions, ours aren't resolved until this mesh uploads
+    GLStateCache::instance().bindVertexArray(box->m_VAO);
+    box->glDrawElements(GL_TRIANGLES, box->m_indexCount, GL_UNSIGNED_INT, 0);
+}
+
+std::unique_ptr<Mesh> Mesh::createPlaceholderBox() {
+    // 4 vertices per face so each face gets a flat normal
+    static const float corners[6][4][3] = {
+            {{1, 0, 0}, {1, 1, 0}, {1, 1, 1}, {1, 0, 1}},  // +x
+            {{0, 0, 1}, {0, 1, 1}, {0, 1, 0}, {0, 0, 0}},  // -x
+            {{0, 1, 0}, {0, 1, 1}, {1, 1, 1}, {1, 1, 0}},  // +y
+            {{0, 0, 0}, {1, 0, 0}, {1, 0, 1}, {0, 0, 1}},  // -y
+            {{1, 0, 1}, {1, 1, 1}, {0, 1, 1}, {0, 0, 1}},  // +z
+            {{0, 0, 0}, {0, 1, 0}, {1, 1, 0}, {1, 0, 0}},  // -z
+    };
+    static const QVector3D normals[6] = {
+            {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}
+    };
+
+    std::vector<CompactVertex> vertices;
+    std::vector<unsigned int> indices;
+    for (int face = 0; face < 6; ++face) {
+        unsigned int base = unsigned(vertices.size());
+        for (int corner = 0; corner < 4; ++corner) {
+            CompactVertex v{};
+            for (int axis = 0; axis < 3; ++axis) {
+                v.position[axis] = corners[face][corner][axis] > 0.0f ? 65535 : 0;
+            }
+            VertexQuantizer::octEncode(normals[face], v.normal);
+            v.texCoords[0] = qfloat16(0.0f);
+            v.texCoords[1] = qfloat16(0.0f);
+            vertices.push_back(v);
+        }
+        for (unsigned int i : {0u, 1u, 2u, 0u, 2u, 3u}) {
+            indices.push_back(base + i);
+        }
+    }
+
+    MeshData info;
+    info.material = placeholderMaterial();
+    info.boundsMin = QVector3D(0.0f, 0.0f, 0.0f);
+    info.boundsMax = QVector3D(1.0f, 1.0f, 1.0f);
+
+    auto box = std::make_unique<Mesh>(QStringLiteral("placeholder:box"));
+    if (!box->upload(info, vertices.data(), vertices.size(), indices.data(), indices.size())) {
+        return nullptr;
+    }
+    return box;
+}
@@ -0,0 +1,137 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_MESH_H
+#define GARDEN_SIMULATION_MESH_H
+
+#pragma once
+#include <QVector3D>
+#include <QOpenGLFunctions_3_3_Core>
+#include <memory>
+#include <vector>
+#include "model/bakedmesh.h"
+#include "model/compactvertex.h"
+#include "model/meshdata.h"
+#include "renderer/shader.h"
+#include "renderer/texture.h"
+
+// Everything a mesh needs before it touches the GL, built off the GL thread by AssetLoader
+// Either points into a baked file's mapping or owns freshly parsed arrays
+struct MeshPayload {
+    MeshData data;  // material, bounds, and the arrays when parsed from the OBJ
+    std::vector<CompactVertex> compactVertices;
+    std::unique_ptr<BakedMesh> baked;
+};
+
+// Geometry, material and textures loaded from one OBJ file
+// A single Mesh is shared by every Model that uses the same file (see AssetCache),
+// so nothing in here may depend on where an instance is placed
+// Meshes start out Loading and draw a box the size of their bounds (once known) until resident
+class Mesh : protected QOpenGLFunctions_3_3_Core {
+
+public:
+    enum class State {
+        Loading,
+        Resident,
+        Failed
+    };
+
+    explicit Mesh(const QString &objPath);
+    ~Mesh();
+
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+
+    // Synchronous load, same as loadData followed by upload on the GL thread
+    bool load();
+
+    // CPU half of loading, baked file or OBJ parse/optimize/quantize, safe on any thread
+    static bool loadData(const QString &objPath, MeshPayload &payload);
+
+    // GL half of loading, needs the context current
+    bool upload(const MeshPayload &payload);
+
+    // Uploads already parsed mesh data and resolves its textures
+    bool upload(const MeshData &data);
+
+    // Same as upload but vertices/indices can point anywhere, like straight into a mapped file
+    bool upload(const MeshData &info, const Vertex *vertices, size_t vertexCount,
+                const unsigned int *indices, size_t indexCount);
+
+    // Compact vertices have to be quantized against info's bounds
+    bool upload(const MeshData &info, const CompactVertex *vertices, size_t vertexCount,
+                const unsigned int *indices, size_t indexCount);
+
+    // Sets material and texture state then draws, caller sets the model matrix
+    void draw(Shader *shader);
+
+    // Material, texture and vertex decode state for drawing this mesh from some other VAO
+    void applyMaterial(Shader *shader);
+
+    // Points attributes 0-2 of the bound VAO at this mesh's buffers, so other VAOs (like an
+    // InstanceBatch's) can share the geometry. Only valid once resident
+    void bindVertexLayout();
+
+    // Bounds are known before the geometry is resident, so the placeholder can be sized
+    void setPendingBounds(const QVector3D &boundsMin, const QVector3D &boundsMax);
+    void markFailed() { m_state = State::Failed; }
+
+    // Keep a full float copy of the geometry when it's uploaded, for StaticBatch to bake from
+    // Has to be set while the mesh is still loading, the GL copy is the only one otherwise
+    void keepGeometry() { m_keepGeometry = true; }
+    const std::vector<Vertex>& getKeptVertices() const { return m_keptVertices; }
+    const std::vector<unsigned int>& getKeptIndices() const { return m_keptIndices; }
+
+    // Unit cube used as the stand in for meshes that are still loading
+    static std::unique_ptr<Mesh> createPlaceholderBox();
+
+    const QString& getPath() const { return m_path; }
+    const Material& getMaterial() const { return m_material; }
+    const QVector3D& getBoundsMin() const { return m_boundsMin; }
+    const QVector3D& getBoundsMax() const { return m_boundsMax; }
+    bool hasBounds() const { return m_hasBounds; }
+    GLuint getVertexArray() const { return m_VAO; }
+
+    // Sorts draws that share textures/material next to each other, see RenderQueue
+    GLuint materialKey() const;
+    GLsizei getIndexCount() const { return m_indexCount; }
+    VertexFormat getVertexFormat() const { return m_format; }
+    State getState() const { return m_state; }
+    bool isResident() const { return m_state == State::Resident; }
+
+private:
+    struct TextureSlot {
+        std::shared_ptr<Texture> texture;
+        QString type;  // like diffuse, normal, etc
+    };
+
+    QString m_path;
+
+    Material m_material;
+    std::vector<TextureSlot> m_textures;
+
+    GLuint m_VAO, m_VBO, m_EBO;
+    GLuint m_materialUBO;  // MaterialBlock, bound by applyMaterial
+    GLsizei m_indexCount;
+    VertexFormat m_format;
+    State m_state;
+    bool m_hasBounds;
+    bool m_keepGeometry = false;
+    std::vector<Vertex> m_keptVertices;
+    std::vector<unsigned int> m_keptIndices;
+
+    QVector3D m_boundsMin;
+    QVector3D m_boundsMax;
+
+    static bool loadBaked(const QString &objPath, MeshPayload &payload);
+    void drawPlaceholder(Shader *shader);
+    void loadTextures();
+    bool uploadVertices(const MeshData &info, VertexFormat format, const void *vertices, size_t vertexCount,
+                        const unsigned int *indices, size_t indexCount);
+    void setupMesh(const void *vertices, size_t vertexCount,
+                   const unsigned int *indices, size_t indexCount);
+};
+
+
+#endif //GARDEN_SIMULATION_MESH_H
@@ -0,0 +1,55 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_MODELUNIFORMS_H
+#define GARDEN_SIMULATION_MODELUNIFORMS_H
+
+#pragma once
+#include <QGenericMatrix>
+#include <QMatrix4x4>
+#include <QVector3D>
+#include "renderer/shader.h"
+
+// Handles for the plain uniforms model.vert/model.frag read, get them with shader->handles<ModelUniforms>()
+// Camera, light and material values live in the Frame and Material blocks (uniformblocks.h)
+struct ModelUniforms {
+    UniformHandle<QMatrix4x4> model;
+    UniformHandle<QMatrix3x3> normalMatrix;  // set with model, see NormalMatrix::of
+
+    UniformHandle<int> diffuseMap, normalMap;
+    UniformHandle<bool> hasDiffuseMap, hasNormalMap;
+
+    UniformHandle<bool> compactVertices, instanced;
+    UniformHandle<bool> bakedTint;  // StaticBatch, tint per vertex on the instance tint slot
+    UniformHandle<QVector3D> positionOffset, positionScale;
+
+    UniformHandle<bool> isPreview;
+    UniformHandle<QVector3D> previewColor;
+    UniformHandle<float> previewAlpha;
+
+    UniformHandle<int> lightData, lightGrid;  // point light texture buffers, see LightClusters
+
+    explicit ModelUniforms(const Shader &shader)
+            : model(shader.uniform<QMatrix4x4>("model"))
+            , normalMatrix(shader.uniform<QMatrix3x3>("normalMatrix"))
+            , diffuseMap(shader.uniform<int>("diffuseMap"))
+            , normalMap(shader.uniform<int>("normalMap"))
+            , hasDiffuseMap(shader.uniform<bool>("hasDiffuseMap"))
+            , hasNormalMap(shader.uniform<bool>("hasNormalMap"))
+            , compactVertices(shader.uniform<bool>("compactVertices"))
+            , instanced(shader.uniform<bool>("instanced"))
+            , bakedTint(shader.uniform<bool>("bakedTint"))
+            , positionOffset(shader.uniform<QVector3D>("positionOffset"))
+            , positionScale(shader.uniform<QVector3D>("positionScale"))
+            , isPreview(shader.uniform<bool>("isPreview"))
+            , previewColor(shader.uniform<QVector3D>("previewColor"))
+            , previewAlpha(shader.uniform<float>("previewAlpha"))
+            , lightData(shader.uniform<int>("lightData"))
+            , lightGrid(shader.uniform<int>("lightGrid"))
+    {
+    }
+};
+
+
+#endif //GARDEN_SIMULATION_MODELUNIFORMS_H
@@ -0,0 +1,48 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include <cmath>
+#include <cstring>
+#include "normalmatrix.h"
+
+namespace NormalMatrix {
+
+bool hasUniformScale(const QMatrix4x4 &model) {
+    const float *m = model.constData();  // column major
+    QVector3D x(m[0], m[1], m[2]);
+    QVector3D y(m[4], m[5], m[6]);
+    QVector3D z(m[8], m[9], m[10]);
+
+    // Columns the same length and at right angles, relative to the scale so tiny models pass too
+    float lengthSq = x.lengthSquared();
+    float tolerance = 1e-4f * lengthSq;
+    return std::fabs(y.lengthSquared() - lengthSq) <= tolerance &&
+           std::fabs(z.lengthSquared() - lengthSq) <= tolerance &&
+           std::fabs(QVector3D::dotProduct(x, y)) <= tolerance &&
+           std::fabs(QVector3D::dotProduct(x, z)) <= tolerance &&
+           std::fabs(QVector3D::dotProduct(y, z)) <= tolerance;
+}
+
+QMatrix3x3 of(const QMatrix4x4 &model) {
+    if (!hasUniformScale(model)) {
+        return model.normalMatrix();
+    }
+
+    QMatrix3x3 normal;
+    const float *m = model.constData();
+    float *out = normal.data();  // column major as well
+    for (int column = 0; column < 3; ++column) {
+        for (int row = 0; row < 3; ++row) {
+            out[column * 3 + row] = m[column * 4 + row];
+        }
+    }
+    return normal;
+}
+
+void of(const QMatrix4x4 &model, float out[9]) {
+    QMatrix3x3 normal = of(model);
+    std::memcpy(out, normal.constData(), sizeof(float) * 9);
+}
+
+}
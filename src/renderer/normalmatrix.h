@@ -0,0 +1,28 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_NORMALMATRIX_H
+#define GARDEN_SIMULATION_NORMALMATRIX_H
+
+#pragma once
+#include <QGenericMatrix>
+#include <QMatrix4x4>
+
+// Normal matrices worked out on the CPU once per instance, model.vert just multiplies
+namespace NormalMatrix {
+
+// True when the upper 3x3 is a rotation times a single scale factor
+bool hasUniformScale(const QMatrix4x4 &model);
+
+// Inverse transpose of the upper 3x3. With uniform scale that's the 3x3 itself up to length,
+// and the fragment shader normalizes anyway, so that case skips the inverse
+QMatrix3x3 of(const QMatrix4x4 &model);
+
+// Same written as three column major columns
+void of(const QMatrix4x4 &model, float out[9]);
+
+}
+
+
+#endif //GARDEN_SIMULATION_NORMALMATRIX_H
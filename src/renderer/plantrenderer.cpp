@@ -0,0 +1,25 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include "plantrenderer.h"
+
+void PlantRenderer::addPlant(const QPoint &cell, Plant::Type type, const std::shared_ptr<Mesh> &mesh,
+                             const QMatrix4x4 &transform) {
+    if (type < 0 || type >= SpeciesCount) return;
+    m_cells.set(cell, type, mesh, transform);
+}
+
+void PlantRenderer::removePlant(const QPoint &cell) {
+    m_cells.remove(cell);
+}
+
+void PlantRenderer::clear() {
+    m_cells.clear();
+}
+
+int PlantRenderer::draw(Shader *shader) {
+    RenderQueue queue;
+    submit(queue, shader);
+    return queue.flush();
+}
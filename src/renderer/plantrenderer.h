@@ -0,0 +1,52 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_PLANTRENDERER_H
+#define GARDEN_SIMULATION_PLANTRENDERER_H
+
+#pragma once
+#include <QMatrix4x4>
+#include <QPoint>
+#include <memory>
+#include "model/plant.h"
+#include "renderer/cellrenderer.h"
+
+// Draws every placed plant with one instanced draw per species per visible tile (see CellRenderer)
+// Kept in step with GardenModel's plantAdded/plantRemoved, each edit is a swap remove or
+// append in that species' batch, so an edit only uploads the slots it touched
+// Only call from the GUI thread, draw needs the context current
+class PlantRenderer {
+
+public:
+    static constexpr int SpeciesCount = Plant::Tomato + 1;
+
+    PlantRenderer() : m_cells(SpeciesCount) {}
+
+    // Replaces whatever was in the cell
+    void addPlant(const QPoint &cell, Plant::Type type, const std::shared_ptr<Mesh> &mesh,
+                  const QMatrix4x4 &transform);
+    void removePlant(const QPoint &cell);
+    void clear();
+
+    // One packet per species that has plants, per tile
+    void submit(RenderQueue &queue, Shader *shader) { m_cells.submit(queue, shader); }
+
+    // Same but skipping tiles outside the frustum
+    void submit(RenderQueue &queue, Shader *shader, const Frustum &frustum, CullStats &stats) {
+        m_cells.submit(queue, shader, frustum, stats);
+    }
+
+    // Submits and flushes straight away, returns how many draw calls that was
+    int draw(Shader *shader);
+
+    int plantCount() const { return m_cells.instanceCount(); }
+    int speciesPlantCount(Plant::Type type) const { return m_cells.kindInstanceCount(type); }
+
+private:
+    // Kind is the species, every plant of a species shares one mesh through AssetCache
+    CellRenderer m_cells;
+};
+
+
+#endif //GARDEN_SIMULATION_PLANTRENDERER_H
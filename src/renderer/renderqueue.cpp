@@ -0,0 +1,116 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include <algorithm>
+#include <cstring>
+#include "renderqueue.h"
+#include "renderer/glstatecache.h"
+#include "renderer/modeluniforms.h"
+#include "renderer/normalmatrix.h"
+
+namespace {
+
+// Top 16 bits of a positive float keep its order, close enough to sort on
+quint64 depthBits(float depth) {
+    float clamped = std::max(depth, 0.0f);
+    quint32 bits;
+    std::memcpy(&bits, &clamped, sizeof(bits));
+    return bits >> 16;
+}
+
+}
+
+void RenderQueue::submit(const DrawPacket &packet) {
+    if (!packet.shader || !packet.mesh) return;
+    m_order.emplace_back(sortKey(packet), quint32(m_packets.size()));
+    m_packets.push_back(packet);
+    if (packet.section == FrameProfiler::Frame) m_packets.back().section = m_section;
+}
+
+void RenderQueue::clear() {
+    m_packets.clear();
+    m_order.clear();
+}
+
+quint64 RenderQueue::sortKey(const DrawPacket &packet) {
+    GLuint vao = packet.staticBatch ? packet.staticBatch->vertexArray()
+               : packet.batch ? packet.batch->vertexArray() : packet.mesh->getVertexArray();
+    quint64 depth = depthBits(packet.depth);
+    if (packet.pass != RenderPass::Opaque) {
+        depth = 0xFFFF - depth;
+    }
+
+    // Ids wrap at their field width, a collision only costs an extra bind
+    return (quint64(packet.pass) & 0x3) << 62 |
+           (quint64(packet.shader->programId()) & 0x3FFF) << 48 |
+           (quint64(packet.mesh->materialKey()) & 0xFFFF) << 32 |
+           (quint64(vao) & 0xFFFF) << 16 |
+           depth;
+}
+
+void RenderQueue::applyPass(RenderPass pass) {
+    GLStateCache &state = GLStateCache::instance();
+    if (pass == RenderPass::Overlay) {
+        state.setBlend(true);
+        state.setDepthFunc(GL_LEQUAL);
+        state.setDepthMask(false);
+    } else {
+        state.setBlend(false);
+        state.setDepthFunc(GL_LESS);
+        state.setDepthMask(true);
+    }
+}
+
+int RenderQueue::flush(FrameProfiler *profiler) {
+    std::sort(m_order.begin(), m_order.end());
+
+    int drawCalls = 0;
+    bool first = true;
+    RenderPass pass = RenderPass::Opaque;
+    FrameProfiler::Section section = FrameProfiler::Frame;
+    for (const auto &[key, index] : m_order) {
+        const DrawPacket &packet = m_packets[index];
+        if (profiler && packet.section != section) {
+            section = packet.section;
+            if (section == FrameProfiler::Frame) {
+                profiler->end();
+            } else {
+                profiler->begin(section);
+            }
+        }
+        if (first || packet.pass != pass) {
+            pass = packet.pass;
+            applyPass(pass);
+            first = false;
+        }
+
+        Shader *shader = packet.shader;
+        shader->bind();
+        const ModelUniforms &uniforms = shader->handles<ModelUniforms>();
+        bool overlay = pass == RenderPass::Overlay;
+        shader->set(uniforms.isPreview, overlay);
+        if (overlay) {
+            shader->set(uniforms.previewColor, packet.overlayColor.toVector3D());
+            shader->set(uniforms.previewAlpha, packet.overlayColor.w());
+        }
+
+        if (packet.staticBatch) {
+            if (packet.staticBatch->draw(packet.mesh, shader)) ++drawCalls;
+        } else if (packet.batch) {
+            if (packet.batch->draw(packet.mesh, shader)) ++drawCalls;
+        } else {
+            shader->set(uniforms.model, packet.model);
+            shader->set(uniforms.normalMatrix, NormalMatrix::of(packet.model));
+            packet.mesh->draw(shader);
+            ++drawCalls;
+        }
+    }
+
+    if (pass != RenderPass::Opaque) {
+        applyPass(RenderPass::Opaque);
+    }
+    if (profiler) profiler->end();
+    clear();
+    return drawCalls;
+}
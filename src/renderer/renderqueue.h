@@ -0,0 +1,69 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_RENDERQUEUE_H
+#define GARDEN_SIMULATION_RENDERQUEUE_H
+
+#pragma once
+#include <QMatrix4x4>
+#include <QVector4D>
+#include <utility>
+#include <vector>
+#include "renderer/frameprofiler.h"
+#include "renderer/instancebatch.h"
+#include "renderer/mesh.h"
+#include "renderer/shader.h"
+#include "renderer/staticbatch.h"
+
+// Passes run in this order, each sets its own depth/blend state
+enum class RenderPass : quint8 {
+    Opaque = 0,
+    Overlay = 1  // see-through highlights (drag preview, delete hover), blended and no depth writes
+};
+
+// One draw of a mesh with the model shader, either once with model, through an InstanceBatch,
+// or as the material of a StaticBatch
+struct DrawPacket {
+    RenderPass pass = RenderPass::Opaque;
+    Shader *shader = nullptr;
+    Mesh *mesh = nullptr;
+    InstanceBatch *batch = nullptr;  // when set the batch's transforms are used and model is ignored
+    StaticBatch *staticBatch = nullptr;  // pre-transformed geometry, mesh only supplies the material
+    QMatrix4x4 model;
+    QVector4D overlayColor;          // rgb and alpha, Overlay pass only
+    float depth = 0.0f;              // distance from the camera
+    FrameProfiler::Section section = FrameProfiler::Frame;  // what the profiler bills it to, Frame for nothing
+};
+
+// Collects a frame's draws, sorts them so binds are shared, then submits through GLStateCache
+// Key from the top: pass (2 bits), program (14), material (16), VAO (16), depth (16)
+// Opaque depth sorts front to back for early z, overlays back to front so blending stacks right
+class RenderQueue {
+
+public:
+    void submit(const DrawPacket &packet);
+
+    // Section for packets submitted without one, so whole renderers can be billed without knowing
+    void setSection(FrameProfiler::Section section) { m_section = section; }
+
+    // Sorts, draws and empties the queue, returns the number of draw calls
+    // Leaves the opaque pass state behind, which is what everything outside the queue expects
+    // With a profiler every run of packets from one section is timed as that section
+    int flush(FrameProfiler *profiler = nullptr);
+
+    void clear();
+    int packetCount() const { return int(m_packets.size()); }
+
+    static quint64 sortKey(const DrawPacket &packet);
+
+private:
+    std::vector<DrawPacket> m_packets;
+    std::vector<std::pair<quint64, quint32>> m_order;  // key, packet index
+    FrameProfiler::Section m_section = FrameProfiler::Frame;
+
+    static void applyPass(RenderPass pass);
+};
+
+
+#endif //GARDEN_SIMULATION_RENDERQUEUE_H
@@ -0,0 +1,441 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include <QDebug>
+#include <algorithm>
+#include "scenerenderer.h"
+#include "model/gardenmodel.h"
+#include "renderer/assetcache.h"
+#include "renderer/shadercache.h"
+
+SceneRenderer::SceneRenderer(const QString &resourceDir) : m_resourceDir(resourceDir) {
+}
+
+SceneRenderer::~SceneRenderer() {
+    if (!m_initialized) return;
+
+    // Last chance with a context for the cache's shared placeholder, see AssetCache::releasePlaceholder
+    AssetCache::instance().releasePlaceholder();
+
+    GLStateCache &state = GLStateCache::instance();
+    state.forgetVertexArray(m_gridVAO);
+    state.forgetVertexArray(m_sunVAO);
+    glDeleteVertexArrays(1, &m_gridVAO);
+    glDeleteVertexArrays(1, &m_sunVAO);
+    glDeleteBuffers(1, &m_gridVBO);
+    glDeleteBuffers(1, &m_sunVBO);
+}
+
+bool SceneRenderer::initialize() {
+    initializeOpenGLFunctions();
+    glClearColor(0.529f, 0.808f, 0.922f, 1.0f);
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    m_clock.start();
+
+    // Merged static beds where instancing is known to be slow (software rasterizers walk every
+    // instance attribute per vertex), GARDEN_STATIC_BEDS=0/1 overrides either way
+    QString renderer = QString::fromLatin1(reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    m_staticBeds = renderer.contains("llvmpipe") || renderer.contains("softpipe") ||
+                   renderer.contains("SwiftShader") || renderer.contains("Software");
+    if (qEnvironmentVariableIsSet("GARDEN_STATIC_BEDS")) {
+        m_staticBeds = qEnvironmentVariableIntValue("GARDEN_STATIC_BEDS") != 0;
+    }
+
+    bool shadersReady = initializeShaders();
+    initializeGridLines();
+    initializeSun();
+
+    m_bedModel = std::make_unique<Model>();
+    if (!m_bedModel->loadModel(resourcePath("models/bed.obj"))) {
+        qDebug() << "Failed to load garden bed model";
+        m_bedModel.reset();
+    } else {
+        // StaticBatch bakes the beds from this copy, set before the upload gets to it
+        m_bedModel->getMesh()->keepGeometry();
+    }
+
+    m_initialized = true;
+    return shadersReady;
+}
+
+bool SceneRenderer::initializeShaders() {
+    QElapsedTimer timer;
+    timer.start();
+
+    m_gridShader = std::make_unique<Shader>(resourcePath("shaders/grid.vert"), resourcePath("shaders/grid.frag"));
+    m_modelShader = std::make_unique<Shader>(resourcePath("shaders/model.vert"), resourcePath("shaders/model.frag"));
+    m_sunShader = std::make_unique<Shader>(resourcePath("shaders/sun.vert"), resourcePath("shaders/sun.frag"));
+
+    // The three don't depend on each other, so they're built in one go
+    ShaderCache cache;
+    if (!cache.build({m_gridShader.get(), m_modelShader.get(), m_sunShader.get()})) {
+        qDebug() << "Failed to compile shaders";
+        return false;
+    }
+    qDebug() << "Shaders ready in" << timer.nsecsElapsed() / 1e6 << "ms," << cache.cacheHits()
+             << "of 3 from the binary cache";
+    return true;
+}
+
+void SceneRenderer::initializeGridLines() {
+    glGenVertexArrays(1, &m_gridVAO);
+    glGenBuffers(1, &m_gridVBO);
+
+    GLStateCache::instance().bindVertexArray(m_gridVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_gridVBO);
+
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float),
+                          (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    // Lines themselves come from updateGridLines once the garden size is known
+}
+
+void SceneRenderer::initializeSun() {
+    // Define vertices for a complete cube
+    static const float vertices[] = {
+            // Front face         // Normal
+            -0.5f, -0.5f, -0.5f, 0.0f, 0.0f, -1.0f,  // Bottom left
+            0.5f, -0.5f, -0.5f,  0.0f, 0.0f, -1.0f,  // Bottom right
+            0.5f, 0.5f, -0.5f,   0.0f, 0.0f, -1.0f,  // Top right
+            -0.5f, -0.5f, -0.5f, 0.0f, 0.0f, -1.0f,  // Bottom left
+            0.5f, 0.5f, -0.5f,   0.0f, 0.0f, -1.0f,  // Top right
+            -0.5f, 0.5f, -0.5f,  0.0f, 0.0f, -1.0f,  // Top left
+
+            // Back face
+            -0.5f, -0.5f, 0.5f,  0.0f, 0.0f, 1.0f,
+            0.5f, -0.5f, 0.5f,   0.0f, 0.0f, 1.0f,
+            0.5f, 0.5f, 0.5f,    0.0f, 0.0f, 1.0f,
+            -0.5f, -0.5f, 0.5f,  0.0f, 0.0f, 1.0f,
+            0.5f, 0.5f, 0.5f,    0.0f, 0.0f, 1.0f,
+            -0.5f, 0.5f, 0.5f,   0.0f, 0.0f, 1.0f,
+
+            // Left face
+            -0.5f, -0.5f, 0.5f,  -1.0f, 0.0f, 0.0f,
+            -0.5f, -0.5f, -0.5f, -1.0f, 0.0f, 0.0f,
+            -0.5f, 0.5f, -0.5f,  -1.0f, 0.0f, 0.0f,
+            -0.5f, -0.5f, 0.5f,  -1.0f, 0.0f, 0.0f,
+            -0.5f, 0.5f, -0.5f,  -1.0f, 0.0f, 0.0f,
+            -0.5f, 0.5f, 0.5f,   -1.0f, 0.0f, 0.0f,
+
+            // Right face
+            0.5f, -0.5f, 0.5f,   1.0f, 0.0f, 0.0f,
+            0.5f, -0.5f, -0.5f,  1.0f, 0.0f, 0.0f,
+            0.5f, 0.5f, -0.5f,   1.0f, 0.0f, 0.0f,
+            0.5f, -0.5f, 0.5f,   1.0f, 0.0f, 0.0f,
+            0.5f, 0.5f, -0.5f,   1.0f, 0.0f, 0.0f,
+            0.5f, 0.5f, 0.5f,    1.0f, 0.0f, 0.0f,
+
+            // Top face
+            -0.5f, 0.5f, -0.5f,  0.0f, 1.0f, 0.0f,
+            0.5f, 0.5f, -0.5f,   0.0f, 1.0f, 0.0f,
+            0.5f, 0.5f, 0.5f,    0.0f, 1.0f, 0.0f,
+            -0.5f, 0.5f, -0.5f,  0.0f, 1.0f, 0.0f,
+            0.5f, 0.5f, 0.5f,    0.0f, 1.0f, 0.0f,
+            -0.5f, 0.5f, 0.5f,   0.0f, 1.0f, 0.0f,
+
+            // Bottom face
+            -0.5f, -0.5f, -0.5f, 0.0f, -1.0f, 0.0f,
+            0.5f, -0.5f, -0.5f,  0.0f, -1.0f, 0.0f,
+            0.5f, -0.5f, 0.5f,   0.0f, -1.0f, 0.0f,
+            -0.5f, -0.5f, -0.5f, 0.0f, -1.0f, 0.0f,
+            0.5f, -0.5f, 0.5f,   0.0f, -1.0f, 0.0f,
+            -0.5f, -0.5f, 0.5f,  0.0f, -1.0f, 0.0f
+    };
+
+    // The cube never changes, so it's uploaded once and only the uniforms move it
+    glGenVertexArrays(1, &m_sunVAO);
+    glGenBuffers(1, &m_sunVBO);
+    GLStateCache::instance().bindVertexArray(m_sunVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_sunVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    // Position attribute
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    // Normal attribute
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float),
+                          (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void SceneRenderer::updateGridLines(int gridSize) {
+    if (gridSize == m_gridLinesSize) return;
+
+    std::vector<float> gridVertices;
+    auto addVertex = [&gridVertices](float x, float z) {
+        gridVertices.insert(gridVertices.end(), {x, 0.0f, z, 0.0f, 1.0f, 0.0f});  // position, normal up
+    };
+    for (int i = 0; i <= gridSize; ++i) {
+        // Horizontal lines
+        addVertex(0.0f, float(i));
+        addVertex(float(gridSize), float(i));
+
+        // Vertical lines
+        addVertex(float(i), 0.0f);
+        addVertex(float(i), float(gridSize));
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_gridVBO);
+    glBufferData(GL_ARRAY_BUFFER, gridVertices.size() * sizeof(float),
+                 gridVertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_gridVertexCount = GLsizei(gridVertices.size() / 6);
+    m_gridLinesSize = gridSize;
+}
+
+void SceneRenderer::render(const Camera &camera, int gridSize, const OverlayCallback &overlays) {
+    Shader::resetFrameStats();
+    GLStateCache &state = GLStateCache::instance();
+
+    // Qt can change state between frames behind the cache's back, so start from nothing known
+    state.invalidate();
+    state.resetStats();
+    state.setDepthMask(true);  // glClear only clears depth with writes on
+    state.setDepthFunc(GL_LESS);
+    state.setBlend(false);
+
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    if (!m_initialized) return;
+    m_profiler.beginFrame();
+
+    // Cached in the camera, only rebuilt when it moved since the last frame
+    const QMatrix4x4 &view = camera.getViewMatrix();
+    const QMatrix4x4 &projection = camera.getProjectionMatrix();
+
+    // Point lights into this view's clusters, before the frame block that carries the slice parameters
+    m_profiler.begin(FrameProfiler::Lights);
+    m_lightClusters.update(camera);
+    m_lightClusters.bind();
+    m_profiler.end();
+
+    // Camera and sun for every program in one upload
+    m_sunPosition = QVector3D(gridSize / 2.0f, 8.0f, gridSize / 2.0f);  // Center above garden
+    FrameBlock frame(view, projection, camera.getPosition(), m_sunPosition,
+                     calculateSunColor(m_temperature), m_clock.nsecsElapsed() / 1e9f);
+    QVector4D clusters = m_lightClusters.frameParameters();
+    for (int i = 0; i < 4; ++i) frame.clusters[i] = clusters[i];
+    m_stream.resetStats();
+    m_frameUniforms.update(frame, m_stream);
+
+    // Draw grid, it's a flat colour so the sun doesn't touch it
+    m_profiler.begin(FrameProfiler::Grid);
+    updateGridLines(gridSize);
+    m_gridShader->bind();
+    m_gridShader->setVec3("gridColor", QVector3D(0.8f, 0.8f, 0.8f));
+    QMatrix4x4 model;
+    m_gridShader->setMat4("model", model);
+    state.bindVertexArray(m_gridVAO);
+    glDrawArrays(GL_LINES, 0, m_gridVertexCount);
+
+    m_profiler.begin(FrameProfiler::Sun);
+    renderSun();
+
+    // Beds and plants only for the tiles the camera can see, the queue bills their draws to them
+    const Frustum &frustum = camera.getFrustum();
+    m_cullStats = CullStats();
+    m_profiler.begin(FrameProfiler::Beds);
+    m_renderQueue.setSection(FrameProfiler::Beds);
+    queueBeds(gridSize, frustum);
+
+    // Plants, one instanced draw per species per visible tile
+    m_profiler.begin(FrameProfiler::Plants);
+    m_renderQueue.setSection(FrameProfiler::Plants);
+    m_plantRenderer.submit(m_renderQueue, m_modelShader.get(), frustum, m_cullStats);
+    m_profiler.end();
+    m_renderQueue.setSection(FrameProfiler::Frame);
+
+    if (overlays) {
+        overlays(m_renderQueue, frustum);
+    }
+    m_renderQueue.flush(m_profiler.isEnabled() ? &m_profiler : nullptr);
+    m_stream.endFrame();
+    m_profiler.endFrame();
+
+    m_streamStats = m_stream.stats();
+    m_uniformStats = Shader::frameStats();
+    m_stateStats = state.stats();
+}
+
+void SceneRenderer::queueBeds(int gridSize, const Frustum &frustum) {
+    if (!m_bedModel) return;
+
+    // One draw for the whole static batch or one instanced draw per visible tile
+    bool staticBeds = usesStaticBeds(gridSize) && m_bedModel->getMesh()->isResident();
+    if (staticBeds) {
+        updateStaticBeds(gridSize);
+        staticBeds = m_staticBeds;
+    }
+    if (!staticBeds) {
+        if (!m_staticBedBatch.isEmpty() && !usesStaticBeds(gridSize)) {
+            // Grown past the cap, the merged copies aren't coming back at this size
+            m_staticBedBatch.clear();
+            m_staticBedGridSize = -1;
+        }
+        updateBedInstances(gridSize);
+        m_bedRenderer.submit(m_renderQueue, m_modelShader.get(), frustum, m_cullStats);
+        return;
+    }
+
+    if (m_bedBatchGridSize != -1) {
+        // Instanced beds from before the switch, their buffers aren't drawn anymore
+        m_bedRenderer.clear();
+        m_bedBatchGridSize = -1;
+    }
+
+    if (m_staticBedBatch.isEmpty()) return;
+    if (!frustum.isVisible(m_staticBedBatch.bounds())) {
+        ++m_cullStats.tilesCulled;
+        m_cullStats.instancesCulled += m_staticBedBatch.copyCount();
+        return;
+    }
+    DrawPacket beds;
+    beds.shader = m_modelShader.get();
+    beds.mesh = m_bedModel->getMesh();
+    beds.staticBatch = &m_staticBedBatch;
+    m_renderQueue.submit(beds);
+    ++m_cullStats.tilesVisible;
+    m_cullStats.instancesVisible += m_staticBedBatch.copyCount();
+}
+
+void SceneRenderer::updateBedInstances(int gridSize) {
+    if (gridSize == m_bedBatchGridSize && !m_bedTintsDirty) return;
+
+    // A smaller garden leaves beds behind otherwise, a tint change just overwrites slots
+    if (gridSize != m_bedBatchGridSize) {
+        m_bedRenderer.clear();
+    }
+    for (int x = 0; x < gridSize; ++x) {
+        for (int z = 0; z < gridSize; ++z) {
+            m_bedModel->setPosition(QVector3D(x + 0.5f, 0.0f, z + 0.5f));
+            m_bedRenderer.set(QPoint(x, z), 0, m_bedModel->getSharedMesh(), m_bedModel->getModelMatrix(),
+                              bedTint());
+        }
+    }
+
+    m_bedBatchGridSize = gridSize;
+    m_bedTintsDirty = false;
+}
+
+void SceneRenderer::updateStaticBeds(int gridSize) {
+    if (gridSize == m_staticBedGridSize && !m_bedTintsDirty) return;
+
+    // Geometry only when the garden size changes, moisture just re-uploads the tints
+    if (gridSize != m_staticBedGridSize) {
+        std::vector<QMatrix4x4> transforms;
+        transforms.reserve(size_t(gridSize) * gridSize);
+        for (int x = 0; x < gridSize; ++x) {
+            for (int z = 0; z < gridSize; ++z) {
+                m_bedModel->setPosition(QVector3D(x + 0.5f, 0.0f, z + 0.5f));
+                transforms.push_back(m_bedModel->getModelMatrix());
+            }
+        }
+        if (!m_staticBedBatch.build(*m_bedModel->getMesh(), transforms)) {
+            qDebug() << "Static beds failed, going back to instancing";
+            m_staticBeds = false;
+            return;
+        }
+        m_staticBedGridSize = gridSize;
+    }
+    m_staticBedBatch.setTints(std::vector<QVector4D>(size_t(m_staticBedBatch.copyCount()), bedTint()));
+    m_bedTintsDirty = false;
+}
+
+QVector4D SceneRenderer::bedTint() const {
+    // Wetter soil is darker
+    float shade = 1.0f - 0.4f * std::clamp(m_moisture, 0.0f, 1.0f);
+    return QVector4D(shade, shade, shade, 1.0f);
+}
+
+void SceneRenderer::setMoisture(float moisture) {
+    m_moisture = moisture;
+    m_bedTintsDirty = true;
+}
+
+void SceneRenderer::addPlant(const QPoint &cell, Plant::Type type, const std::shared_ptr<Mesh> &mesh) {
+    QMatrix4x4 transform;
+    transform.translate(cell.x() + 0.5f, 0.0f, cell.y() + 0.5f);
+    m_plantRenderer.addPlant(cell, type, mesh, transform);
+}
+
+void SceneRenderer::removePlant(const QPoint &cell) {
+    m_plantRenderer.removePlant(cell);
+}
+
+void SceneRenderer::syncPlants(const GardenModel &garden) {
+    m_plantRenderer.clear();
+    for (int x = 0; x < garden.getGridSize(); ++x) {
+        for (int z = 0; z < garden.getGridSize(); ++z) {
+            Plant *plant = garden.getPlant(QPoint(x, z));
+            if (plant) {
+                addPlant(QPoint(x, z), plant->getType(), plant->getModel()->getSharedMesh());
+            }
+        }
+    }
+}
+
+void SceneRenderer::renderSun() {
+    // Bind sun shader
+    m_sunShader->bind();
+
+    // Create model matrix for sun
+    QMatrix4x4 model;
+    model.translate(m_sunPosition);
+    model.scale(1.0f);
+
+    // Set shader uniforms, view and projection come from the frame block
+    m_sunShader->setMat4("model", model);
+
+    // Sun color and brightness (hotter is brighter) from the temperature
+    QVector4D lighting = sunLighting(m_temperature);
+    m_sunShader->setVec3("sunColor", lighting.toVector3D());
+    m_sunShader->setFloat("intensity", lighting.w());
+
+    // Draw the sun cube
+    GLStateCache::instance().bindVertexArray(m_sunVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 36);
+}
+
+QVector4D SceneRenderer::sunLighting(float temperature) {
+    float intensity = std::clamp(1.0f + (temperature - 60.0f) / 30.0f, 0.5f, 2.0f);
+    return QVector4D(calculateSunColor(temperature), intensity);
+}
+
+QVector3D SceneRenderer::calculateSunColor(float temperature) {
+    // Normalize temperature to 0-1 range (30F to 90F)
+    float t = (temperature - 30.0f) / 60.0f;
+    t = std::max(0.0f, std::min(1.0f, t));  // Clamp to 0-1
+
+    // Define color ranges for different temperatures
+    QVector3D coldColor(0.6f, 0.7f, 1.0f);    // Cool blueish
+    QVector3D midColor(1.0f, 0.95f, 0.8f);    // Neutral warm
+    QVector3D hotColor(1.0f, 0.6f, 0.4f);     // Warm orangey red
+
+    // Interpolate between colors
+    if (t < 0.5f) {
+        return interpolateColors(coldColor, midColor, t * 2.0f);
+    } else {
+        return interpolateColors(midColor, hotColor, (t - 0.5f) * 2.0f);
+    }
+}
+
+QVector3D SceneRenderer::interpolateColors(const QVector3D& color1, const QVector3D& color2, float t) {
+    // Clamp t to [0,1] range
+    t = std::max(0.0f, std::min(1.0f, t));
+
+    // Linearly interpolate each component
+    return QVector3D(
+            color1.x() + (color2.x() - color1.x()) * t,
+            color1.y() + (color2.y() - color1.y()) * t,
+            color1.z() + (color2.z() - color1.z()) * t
+    );
+}
@@ -0,0 +1,162 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_SCENERENDERER_H
+#define GARDEN_SIMULATION_SCENERENDERER_H
+
+#pragma once
+#include <QElapsedTimer>
+#include <QOpenGLFunctions_3_3_Core>
+#include <QPoint>
+#include <QVector3D>
+#include <QVector4D>
+#include <functional>
+#include <memory>
+#include "model/model.h"
+#include "model/plant.h"
+#include "renderer/camera.h"
+#include "renderer/cellrenderer.h"
+#include "renderer/frameprofiler.h"
+#include "renderer/glstatecache.h"
+#include "renderer/lightclusters.h"
+#include "renderer/plantrenderer.h"
+#include "renderer/renderqueue.h"
+#include "renderer/shader.h"
+#include "renderer/staticbatch.h"
+#include "renderer/streambuffer.h"
+#include "renderer/uniformblocks.h"
+
+class GardenModel;
+
+// Everything the garden view draws (grid, beds, plants, sun), with no widget attached
+// Renders into whatever framebuffer is bound, so GardenGLWidget and the headless
+// garden_snapshot tool share it. Shaders and the bed model are read from resourceDir
+// Needs the context current for initialize, render and the destructor, and for removePlant and
+// clearPlants too since an emptied tile takes its instance buffers with it
+class SceneRenderer : protected QOpenGLFunctions_3_3_Core {
+
+public:
+    // The checkout this was built from, see GARDEN_SOURCE_DIR in CMakeLists.txt
+    static constexpr const char *DefaultResourceDir = GARDEN_SOURCE_DIR;
+
+    // Extra packets after the scene is culled, like the widget's drag preview and highlights
+    using OverlayCallback = std::function<void(RenderQueue &queue, const Frustum &frustum)>;
+
+    explicit SceneRenderer(const QString &resourceDir = DefaultResourceDir);
+    ~SceneRenderer();
+
+    SceneRenderer(const SceneRenderer&) = delete;
+    SceneRenderer& operator=(const SceneRenderer&) = delete;
+
+    // Shaders, grid, bed model and sun, false if the shaders didn't build
+    bool initialize();
+
+    // Clears and draws one frame for camera, the caller sets the viewport
+    void render(const Camera &camera, int gridSize, const OverlayCallback &overlays = {});
+
+    // Plants follow GardenModel's signals, syncPlants starts over from the whole model
+    void addPlant(const QPoint &cell, Plant::Type type, const std::shared_ptr<Mesh> &mesh);
+    void removePlant(const QPoint &cell);
+    void clearPlants() { m_plantRenderer.clear(); }
+    void syncPlants(const GardenModel &garden);
+
+    // Grow lamps and path lights, lit through LightClusters on top of the sun
+    void setLights(const std::vector<GardenLight> &lights) { m_lightClusters.setLights(lights); }
+
+    void setTemperature(float temperature) { m_temperature = temperature; }
+    void setMoisture(float moisture);
+
+    // Sun colour (rgb) and intensity (w) for a temperature, also what the model shader lights with
+    static QVector4D sunLighting(float temperature);
+    static QVector3D calculateSunColor(float temperature);
+
+    Shader* modelShader() const { return m_modelShader.get(); }
+    int plantCount() const { return m_plantRenderer.plantCount(); }
+    // Whether beds for a garden this size go through the merged static batch
+    bool usesStaticBeds(int gridSize) const {
+        return m_staticBeds && gridSize * gridSize <= MaxStaticBedCells;
+    }
+
+    // Uniform calls, state cache binds, culling and streamed uploads of the last render
+    Shader::UniformStats lastUniformStats() const { return m_uniformStats; }
+    GLStateCache::Stats lastStateStats() const { return m_stateStats; }
+    CullStats lastCullStats() const { return m_cullStats; }
+    StreamBuffer::Stats lastStreamStats() const { return m_streamStats; }
+    LightClusters::Stats lastLightStats() const { return m_lightClusters.stats(); }
+
+    // Per pass CPU and GPU times, off until someone enables it
+    FrameProfiler& profiler() { return m_profiler; }
+    const FrameProfiler& profiler() const { return m_profiler; }
+
+private:
+    QString m_resourceDir;
+    bool m_initialized = false;
+
+    std::unique_ptr<Shader> m_gridShader;
+    std::unique_ptr<Shader> m_modelShader;
+    std::unique_ptr<Shader> m_sunShader;
+    std::unique_ptr<Model> m_bedModel;
+
+    // Beds as instanced tiles, redone when the grid size or moisture changes
+    CellRenderer m_bedRenderer{1};
+    int m_bedBatchGridSize = -1;
+    bool m_bedTintsDirty = true;
+
+    // Or every bed merged into one pre-transformed buffer, for contexts where instancing is slow
+    // Picked in initialize, until the bed mesh is resident the instanced path draws the placeholders
+    // Every cell is a full copy of the bed mesh, so past MaxStaticBedCells it's instancing anyway
+    static constexpr int MaxStaticBedCells = 32 * 32;
+    bool m_staticBeds = false;
+    StaticBatch m_staticBedBatch;
+    int m_staticBedGridSize = -1;
+
+    // Placed plants, one instanced draw per species per visible tile
+    PlantRenderer m_plantRenderer;
+
+    // Model shader draws for the frame, sorted by state before they're submitted
+    RenderQueue m_renderQueue;
+
+    // Data written every frame goes through here, a few frames' worth so it never waits on the GPU
+    StreamBuffer m_stream{256 * 1024};
+
+    // Camera and sun for all programs, updated once per frame
+    FrameUniformBuffer m_frameUniforms;
+
+    // Point lights per view space cluster, reassigned when the camera or the lights move
+    LightClusters m_lightClusters;
+    QElapsedTimer m_clock;  // frame block time
+
+    FrameProfiler m_profiler;
+
+    // Grid lines follow the garden size and are rebuilt only when it changes
+    GLuint m_gridVAO = 0, m_gridVBO = 0;
+    GLsizei m_gridVertexCount = 0;
+    int m_gridLinesSize = -1;
+
+    GLuint m_sunVAO = 0, m_sunVBO = 0;
+    QVector3D m_sunPosition;
+
+    float m_temperature = 60.0f;  // °F, sun colour
+    float m_moisture = 0.5f;      // bed darkness
+
+    Shader::UniformStats m_uniformStats;
+    GLStateCache::Stats m_stateStats;
+    CullStats m_cullStats;
+    StreamBuffer::Stats m_streamStats;
+
+    QString resourcePath(const QString &relative) const { return m_resourceDir + "/" + relative; }
+    bool initializeShaders();
+    void initializeGridLines();
+    void initializeSun();
+    void updateGridLines(int gridSize);
+    void updateBedInstances(int gridSize);
+    void updateStaticBeds(int gridSize);
+    void queueBeds(int gridSize, const Frustum &frustum);
+    QVector4D bedTint() const;
+    void renderSun();
+    static QVector3D interpolateColors(const QVector3D &color1, const QVector3D &color2, float t);
+};
+
+
+#endif //GARDEN_SIMULATION_SCENERENDERER_H
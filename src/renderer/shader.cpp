@@ -3,7 +3,14 @@
 //
 
 #include <QFile>
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <algorithm>
+#include <cstring>
 #include "shader.h"
+#include "glstatecache.h"
+#include "shadercache.h"
+#include "uniformblocks.h"
 
 
 Shader::Shader(const QString &vertexPath, const QString &fragmentPath) :
@@ -20,17 +27,23 @@ Shader::~Shader() {
     }
 }
 
+Shader::UniformStats Shader::s_stats;
+
 bool Shader::compile() {
     if (m_isCompiled) return true;
 
-    // Load and compile vertex shader
+    ShaderCache cache;
+    return cache.build({this});
+}
+
+bool Shader::readSources(QByteArray &vertexCode, QByteArray &fragmentCode) const {
+    // Load vertex shader
     QFile vertexFile(m_vertexPath);
     if (!vertexFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
         qDebug() << "Failed to open vertex shader: " << m_vertexPath;
         return false;
     }
-
-    QString vertexCode = QTextStream(&vertexFile).readAll();
+    vertexCode = vertexFile.readAll();
     vertexFile.close();
 
     // And fragment shader
@@ -39,61 +52,156 @@ bool Shader::compile() {
         qDebug() << "Failed to open fragment shader: " << m_fragmentPath;
         return false;
     }
-    QString fragmentCode = QTextStream(&fragmentFile).readAll();
+    fragmentCode = fragmentFile.readAll();
     fragmentFile.close();
+    return true;
+}
 
-    // Add shaders to program
-    if (!m_program->addShaderFromSourceCode(QOpenGLShader::Vertex, vertexCode)) {
-        qDebug() << "Vertex shader compilation failed";
-        return false;
+void Shader::bind() {
+    if (m_isCompiled) {
+        GLStateCache::instance().useProgram(m_program->programId());
     }
+}
 
-    if (!m_program->addShaderFromSourceCode(QOpenGLShader::Fragment, fragmentCode)) {
-        qDebug() << "Fragment shader compilation failed";
-        return false;
+void Shader::release() {
+    GLStateCache::instance().useProgram(0);
+}
+
+void Shader::markLinked() {
+    m_isCompiled = true;
+
+    // GLSL 330 can't say which binding a block uses, so attach the shared ones here
+    QOpenGLExtraFunctions *gl = QOpenGLContext::currentContext()->extraFunctions();
+    GLuint program = m_program->programId();
+    for (auto [name, binding] : {std::pair{"Frame", FrameBlockBinding}, std::pair{"Material", MaterialBlockBinding}}) {
+        GLuint index = gl->glGetUniformBlockIndex(program, name);
+        if (index != GL_INVALID_INDEX) {
+            gl->glUniformBlockBinding(program, index, binding);
+        }
     }
 
-    // Link
-    if (!m_program->link()) {
-        qDebug() << "Shader program linking failed";
-        return false;
+    buildUniformTable();
+}
+
+void Shader::buildUniformTable() {
+    // A relink starts over, the program's uniforms are back to their defaults
+    m_uniforms.clear();
+    m_uniformSlots.clear();
+    m_handleSets.clear();
+
+    QOpenGLFunctions *gl = QOpenGLContext::currentContext()->functions();
+    GLuint program = m_program->programId();
+    GLint count = 0;
+    GLint maxLength = 0;
+    gl->glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+    gl->glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    QByteArray name(qsizetype(std::max(maxLength, 1)), '\0');
+    for (GLint i = 0; i < count; ++i) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        gl->glGetActiveUniform(program, GLuint(i), maxLength, &length, &size, &type, name.data());
+
+        // Arrays are listed as name[0], the bare name is what callers use
+        QByteArray uniformName(name.constData(), length);
+        if (uniformName.endsWith("[0]")) uniformName.chop(3);
+
+        // Members of uniform blocks don't have locations
+        GLint location = gl->glGetUniformLocation(program, uniformName.constData());
+        if (location < 0) continue;
+
+        m_uniformSlots.insert(uniformName, int(m_uniforms.size()));
+        m_uniforms.push_back({location, false, {}});
     }
+}
 
-    m_isCompiled = true;
+int Shader::slotFor(const QByteArray &name) const {
+    auto it = m_uniformSlots.constFind(name);
+    if (it != m_uniformSlots.constEnd()) return it.value();
+    if (!m_isCompiled) return -1;
+
+    // Not in the active list, like lights[3], so ask GL once
+    GLint location = m_program->uniformLocation(name.constData());
+    int slot = -1;
+    if (location >= 0) {
+        slot = int(m_uniforms.size());
+        m_uniforms.push_back({location, false, {}});
+    }
+    m_uniformSlots.insert(name, slot);
+    return slot;
+}
+
+bool Shader::changed(int slot, const void *value, size_t bytes) {
+    if (slot < 0 || size_t(slot) >= m_uniforms.size()) return false;
+
+    UniformSlot &uniform = m_uniforms[size_t(slot)];
+    if (uniform.hasValue && std::memcmp(uniform.value, value, bytes) == 0) {
+        ++s_stats.skipped;
+        return false;
+    }
+    std::memcpy(uniform.value, value, bytes);
+    uniform.hasValue = true;
+    ++s_stats.issued;
     return true;
 }
 
-void Shader::bind() {
-    if (m_isCompiled) {
-        m_program->bind();
+void Shader::set(UniformHandle<QMatrix4x4> handle, const QMatrix4x4 &value) {
+    if (changed(handle.slot, value.constData(), 16 * sizeof(float))) {
+        m_program->setUniformValue(m_uniforms[size_t(handle.slot)].location, value);
     }
 }
 
-void Shader::release() {
-    m_program->release();
+void Shader::set(UniformHandle<QMatrix3x3> handle, const QMatrix3x3 &value) {
+    if (changed(handle.slot, value.constData(), 9 * sizeof(float))) {
+        m_program->setUniformValue(m_uniforms[size_t(handle.slot)].location, value);
+    }
+}
+
+void Shader::set(UniformHandle<QVector3D> handle, const QVector3D &value) {
+    float components[3] = {value.x(), value.y(), value.z()};
+    if (changed(handle.slot, components, sizeof(components))) {
+        m_program->setUniformValue(m_uniforms[size_t(handle.slot)].location, value);
+    }
+}
+
+void Shader::set(UniformHandle<float> handle, float value) {
+    if (changed(handle.slot, &value, sizeof(value))) {
+        m_program->setUniformValue(m_uniforms[size_t(handle.slot)].location, value);
+    }
+}
+
+void Shader::set(UniformHandle<int> handle, int value) {
+    if (changed(handle.slot, &value, sizeof(value))) {
+        m_program->setUniformValue(m_uniforms[size_t(handle.slot)].location, value);
+    }
+}
+
+void Shader::set(UniformHandle<bool> handle, bool value) {
+    set(UniformHandle<int>{handle.slot}, value ? 1 : 0);
 }
 
 void Shader::setMat4(const QString &name, const QMatrix4x4 &matrix) {
-    m_program->setUniformValue(name.toStdString().c_str(), matrix);
+    set(UniformHandle<QMatrix4x4>{slotFor(name.toUtf8())}, matrix);
 }
 
 void Shader::setVec3(const QString &name, const QVector3D &vector) {
-    m_program->setUniformValue(name.toStdString().c_str(), vector);
-
+    set(UniformHandle<QVector3D>{slotFor(name.toUtf8())}, vector);
 }
+
 void Shader::setFloat(const QString& name, float value) {
-    m_program->setUniformValue(name.toStdString().c_str(), value);
+    set(UniformHandle<float>{slotFor(name.toUtf8())}, value);
 }
 
 void Shader::setInt(const QString& name, int value) {
-    m_program->setUniformValue(name.toStdString().c_str(), value);
+    set(UniformHandle<int>{slotFor(name.toUtf8())}, value);
 }
 
 void Shader::setBool(const QString& name, bool value) {
-    m_program->setUniformValue(name.toStdString().c_str(), value ? 1 : 0);
-
+    set(UniformHandle<bool>{slotFor(name.toUtf8())}, value);
 }
 
 GLint Shader::getUniformLocation(const QString& name) const {
-    return m_program->uniformLocation(name.toStdString().c_str());
-}
\ No newline at end of file
+    int slot = slotFor(name.toUtf8());
+    return slot >= 0 ? m_uniforms[size_t(slot)].location : -1;
+}
@@ -7,11 +7,24 @@
 #pragma once
 
 #include <OpenGL/gl.h>
+#include <QByteArray>
+#include <QGenericMatrix>
+#include <QHash>
 #include <QOpenGLFunctions>
 #include <QString>
 #include <QOpenGLShaderProgram>
-
-
+#include <memory>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+// Slot in a Shader's uniform table, resolved once with Shader::uniform and set with Shader::set
+// The type only makes sure a handle can't be set with the wrong kind of value
+template<typename T>
+struct UniformHandle {
+    int slot = -1;
+    bool isValid() const { return slot >= 0; }
+};
 
 class Shader {
 
@@ -20,10 +33,46 @@ public:
     Shader(const QString &vertexPath, const QString &fragmentPath);
     ~Shader();
 
+    // Compiles on its own, ShaderCache::build does several at once
     bool compile();
+    // Through GLStateCache, binding the program that's already bound costs nothing
     void bind();
     void release();
 
+    GLuint programId() const { return m_program->programId(); }
+
+    // Uniform calls issued to GL versus skipped because the value was already set
+    struct UniformStats {
+        int issued = 0;
+        int skipped = 0;
+    };
+
+    // Looks name up in the table built at link time, invalid if the program doesn't use it
+    template<typename T>
+    UniformHandle<T> uniform(const char *name) const { return {slotFor(QByteArray(name))}; }
+
+    // Setting a handle to the value it already has doesn't touch GL
+    void set(UniformHandle<QMatrix4x4> handle, const QMatrix4x4 &value);
+    void set(UniformHandle<QMatrix3x3> handle, const QMatrix3x3 &value);
+    void set(UniformHandle<QVector3D> handle, const QVector3D &value);
+    void set(UniformHandle<float> handle, float value);
+    void set(UniformHandle<int> handle, int value);
+    void set(UniformHandle<bool> handle, bool value);
+
+    // A struct of handles built from this shader on first use and kept with it,
+    // Handles needs a constructor taking const Shader&
+    template<typename Handles>
+    const Handles& handles() {
+        auto &entry = m_handleSets[std::type_index(typeid(Handles))];
+        if (!entry) entry = std::make_shared<const Handles>(*this);
+        return *static_cast<const Handles*>(entry.get());
+    }
+
+    // Totals over every shader since the last reset, the widget resets once per frame
+    static UniformStats frameStats() { return s_stats; }
+    static void resetFrameStats() { s_stats = UniformStats(); }
+
+    // By name, same as looking the handle up every call
     void setMat4(const QString &name, const QMatrix4x4 &matrix);
     void setVec3(const QString &name, const QVector3D &vector);
     void setFloat(const QString &name, float value);
@@ -31,7 +80,7 @@ public:
     void setBool(const QString& name, bool value);
 
     bool hasUniform(const QString& name) const {
-        return m_program->uniformLocation(name.toStdString().c_str()) != -1;
+        return slotFor(name.toUtf8()) >= 0;
     }
 
     bool getBoolUniform(const QString& name) const {
@@ -53,10 +102,33 @@ public:
     GLint getUniformLocation(const QString& name) const;
 
 private:
+    friend class ShaderCache;
+
     std::unique_ptr<QOpenGLShaderProgram> m_program;
     QString m_vertexPath;
     QString m_fragmentPath;
     bool m_isCompiled;
+
+    // Flat table of the program's uniforms with the last value sent to each
+    // Filled from the active uniforms at link time, names asked for later (array elements)
+    // are added on first use, misses are remembered as -1
+    struct UniformSlot {
+        GLint location;
+        bool hasValue;
+        float value[16];  // raw bytes of the last value, ints are stored bitwise
+    };
+    mutable std::vector<UniformSlot> m_uniforms;
+    mutable QHash<QByteArray, int> m_uniformSlots;
+
+    std::unordered_map<std::type_index, std::shared_ptr<const void>> m_handleSets;
+
+    static UniformStats s_stats;
+
+    bool readSources(QByteArray &vertexCode, QByteArray &fragmentCode) const;
+    void markLinked();
+    void buildUniformTable();
+    int slotFor(const QByteArray &name) const;
+    bool changed(int slot, const void *value, size_t bytes);
 };
 
 template<>
@@ -0,0 +1,243 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QOpenGLContext>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <cstring>
+#include "model/filehash.h"
+#include "shadercache.h"
+
+static_assert(sizeof(ShaderBinaryHeader) == 24, "header layout is part of the file format");
+
+// Not in every platform's GL headers
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+namespace {
+
+quint64 hashBytes(const QByteArray &bytes, quint64 hash) {
+    return fnv1a64(std::string_view(bytes.constData(), size_t(bytes.size())), hash);
+}
+
+}
+
+ShaderCache::ShaderCache() {
+    initializeOpenGLFunctions();
+
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    if (!context) return;
+
+    // Let the driver spread compiles over its own threads, the ARB name is the older spelling
+    using MaxCompilerThreads = void (*)(GLuint);
+    auto maxThreads = reinterpret_cast<MaxCompilerThreads>(context->getProcAddress("glMaxShaderCompilerThreadsKHR"));
+    if (!maxThreads) {
+        maxThreads = reinterpret_cast<MaxCompilerThreads>(context->getProcAddress("glMaxShaderCompilerThreadsARB"));
+    }
+    if (maxThreads && (context->hasExtension("GL_KHR_parallel_shader_compile") ||
+                       context->hasExtension("GL_ARB_parallel_shader_compile"))) {
+        maxThreads(0xFFFFFFFF);
+    }
+
+    if (!isEnabled()) return;
+
+    // Program binaries are core in 4.1, a 3.3 context needs the extension
+    // Some drivers advertise it with zero formats, which means no binaries either
+    QSurfaceFormat format = context->format();
+    if (format.version() >= qMakePair(4, 1) || context->hasExtension("GL_ARB_get_program_binary")) {
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        m_binariesSupported = formats > 0;
+    }
+
+    QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (!m_binariesSupported || cacheDir.isEmpty()) {
+        m_binariesSupported = false;
+        return;
+    }
+    m_cacheDir = cacheDir + "/shaders";
+
+    // A binary is only good for the exact driver that produced it
+    QByteArray driver;
+    for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+        driver += reinterpret_cast<const char*>(glGetString(name));
+        driver += '\n';
+    }
+    m_driverHash = hashBytes(driver, 1469598103934665603ull);
+}
+
+bool ShaderCache::isEnabled() {
+    return !qEnvironmentVariableIsSet("GARDEN_NO_SHADER_CACHE");
+}
+
+QString ShaderCache::pathFor(quint64 key) const {
+    return m_cacheDir + "/" + QString::number(key, 16).rightJustified(16, '0') + ".gprog";
+}
+
+bool ShaderCache::build(const std::vector<Shader*> &shaders) {
+    bool ok = true;
+    std::vector<PendingProgram> pending;
+
+    // Cache hits are done straight away, misses get their compiles and links queued
+    for (Shader *shader : shaders) {
+        if (shader->m_isCompiled) continue;
+
+        QByteArray vertexSource;
+        QByteArray fragmentSource;
+        if (!shader->readSources(vertexSource, fragmentSource)) {
+            ok = false;
+            continue;
+        }
+
+        // The separator keeps "ab" + "c" and "a" + "bc" apart
+        quint64 key = hashBytes(fragmentSource, hashBytes(QByteArray(1, '\0'),
+                                hashBytes(vertexSource, m_driverHash)));
+        if (m_binariesSupported && loadBinary(shader, key)) {
+            ++m_cacheHits;
+            continue;
+        }
+
+        if (!shader->m_program->create()) {
+            qDebug() << "Failed to create shader program for" << shader->m_vertexPath;
+            ok = false;
+            continue;
+        }
+
+        GLuint program = shader->m_program->programId();
+        PendingProgram entry{shader, key, compileStage(GL_VERTEX_SHADER, vertexSource),
+                             compileStage(GL_FRAGMENT_SHADER, fragmentSource)};
+        glAttachShader(program, entry.vertexShader);
+        glAttachShader(program, entry.fragmentShader);
+        if (m_binariesSupported) {
+            glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
+        glLinkProgram(program);
+        pending.push_back(entry);
+    }
+
+    // Reading a status is what waits for the driver, so only start now everything is queued
+    for (const PendingProgram &entry : pending) {
+        ok = finish(entry) && ok;
+    }
+    return ok;
+}
+
+GLuint ShaderCache::compileStage(GLenum type, const QByteArray &source) {
+    GLuint shader = glCreateShader(type);
+    const char *code = source.constData();
+    GLint length = GLint(source.size());
+    glShaderSource(shader, 1, &code, &length);
+    glCompileShader(shader);
+    return shader;
+}
+
+bool ShaderCache::finish(const PendingProgram &pending) {
+    Shader *shader = pending.shader;
+    GLuint program = shader->m_program->programId();
+
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        // The stage logs say which file is broken, the program log covers mismatched interfaces
+        for (GLuint stage : {pending.vertexShader, pending.fragmentShader}) {
+            GLint compiled = GL_FALSE;
+            glGetShaderiv(stage, GL_COMPILE_STATUS, &compiled);
+            if (compiled) continue;
+
+            char log[1024] = {};
+            glGetShaderInfoLog(stage, sizeof(log), nullptr, log);
+            qDebug() << (stage == pending.vertexShader ? "Vertex shader compilation failed:" : "Fragment shader compilation failed:")
+                     << (stage == pending.vertexShader ? shader->m_vertexPath : shader->m_fragmentPath) << log;
+        }
+        char log[1024] = {};
+        glGetProgramInfoLog(program, sizeof(log), nullptr, log);
+        qDebug() << "Shader program linking failed" << log;
+    }
+
+    // The program keeps what it needs once linked
+    glDetachShader(program, pending.vertexShader);
+    glDetachShader(program, pending.fragmentShader);
+    glDeleteShader(pending.vertexShader);
+    glDeleteShader(pending.fragmentShader);
+
+    // QOpenGLShaderProgram with no shaders of its own only reads back the link status
+    if (!linked || !shader->m_program->link()) return false;
+
+    shader->markLinked();
+    if (m_binariesSupported) {
+        saveBinary(program, pending.key);
+    }
+    return true;
+}
+
+bool ShaderCache::loadBinary(Shader *shader, quint64 key) {
+    QString path = pathFor(key);
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    QByteArray data = file.readAll();
+    file.close();
+
+    ShaderBinaryHeader header{};
+    bool valid = size_t(data.size()) >= sizeof(header);
+    if (valid) {
+        std::memcpy(&header, data.constData(), sizeof(header));
+        valid = std::memcmp(header.magic, Magic, sizeof(header.magic)) == 0 && header.version == Version &&
+                header.key == key && quint64(header.size) + sizeof(header) == quint64(data.size());
+    }
+
+    if (valid && shader->m_program->create()) {
+        GLuint program = shader->m_program->programId();
+        glProgramBinary(program, GLenum(header.binaryFormat), data.constData() + sizeof(header), GLsizei(header.size));
+
+        // The driver is allowed to reject any binary, that just means compiling again
+        GLint linked = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (linked && shader->m_program->link()) {
+            shader->markLinked();
+            return true;
+        }
+    }
+
+    qDebug() << "Discarding stale shader binary" << path;
+    QFile::remove(path);
+    return false;
+}
+
+void ShaderCache::saveBinary(GLuint program, quint64 key) {
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    QByteArray data(qsizetype(sizeof(ShaderBinaryHeader)) + length, '\0');
+    ShaderBinaryHeader header{};
+    std::memcpy(header.magic, Magic, sizeof(header.magic));
+    header.version = Version;
+    header.key = key;
+
+    GLenum binaryFormat = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &binaryFormat, data.data() + sizeof(header));
+    if (written <= 0) return;
+    header.binaryFormat = quint32(binaryFormat);
+    header.size = quint32(written);
+    std::memcpy(data.data(), &header, sizeof(header));
+    data.truncate(qsizetype(sizeof(header)) + written);
+
+    // A failed write only costs a compile next start
+    QDir().mkpath(m_cacheDir);
+    QSaveFile file(pathFor(key));
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        qDebug() << "Couldn't write shader binary" << pathFor(key);
+    }
+}
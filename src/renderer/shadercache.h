@@ -0,0 +1,72 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_SHADERCACHE_H
+#define GARDEN_SIMULATION_SHADERCACHE_H
+
+#pragma once
+#include <QByteArray>
+#include <QOpenGLExtraFunctions>
+#include <QString>
+#include <vector>
+#include "renderer/shader.h"
+
+// On disk layout of a cached program, native endian
+// [header][driver program binary]
+struct ShaderBinaryHeader {
+    char magic[4];
+    quint32 version;
+    quint32 binaryFormat;  // whatever glGetProgramBinary handed back
+    quint32 size;
+    quint64 key;           // hash of both sources and the driver, guards against a renamed/clobbered file
+};
+
+// Builds shader programs and keeps their linked binaries in the user's cache directory,
+// so later starts load a binary instead of compiling GLSL
+// Entries are keyed by the shader sources plus the GL vendor/renderer/version string, so a
+// driver update or shader edit just misses. Anything that fails to load is deleted and the
+// program is compiled from source like before.
+// Programs that miss are compiled together: every compile and link is issued before any status
+// is read, which lets drivers with KHR_parallel_shader_compile (or a threaded compiler) overlap them.
+class ShaderCache : protected QOpenGLExtraFunctions {
+
+public:
+    static constexpr char Magic[4] = {'G', 'P', 'R', 'G'};
+    static constexpr quint32 Version = 1;
+
+    // Needs the GL context current
+    ShaderCache();
+
+    // Compiles or loads every shader that isn't compiled yet. Returns false if any failed,
+    // the others are still usable
+    bool build(const std::vector<Shader*> &shaders);
+
+    // False when GARDEN_NO_SHADER_CACHE is set, programs are always compiled from source then
+    static bool isEnabled();
+
+    int cacheHits() const { return m_cacheHits; }
+
+private:
+    struct PendingProgram {
+        Shader *shader;
+        quint64 key;
+        GLuint vertexShader;
+        GLuint fragmentShader;
+    };
+
+    QString m_cacheDir;
+    quint64 m_driverHash = 0;
+    bool m_binariesSupported = false;
+    int m_cacheHits = 0;
+
+    QString pathFor(quint64 key) const;
+    bool loadBinary(Shader *shader, quint64 key);
+    void saveBinary(GLuint program, quint64 key);
+
+    GLuint compileStage(GLenum type, const QByteArray &source);
+    bool finish(const PendingProgram &pending);
+};
+
+
+#endif //GARDEN_SIMULATION_SHADERCACHE_H
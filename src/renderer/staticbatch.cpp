@@ -0,0 +1,164 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include <QDebug>
+#include "staticbatch.h"
+#include "renderer/glstatecache.h"
+#include "renderer/modeluniforms.h"
+#include "renderer/normalmatrix.h"
+
+StaticBatch::~StaticBatch() {
+    if (m_VAO) {
+        GLStateCache::instance().forgetVertexArray(m_VAO);
+        glDeleteVertexArrays(1, &m_VAO);
+    }
+    if (m_VBO) glDeleteBuffers(1, &m_VBO);
+    if (m_EBO) glDeleteBuffers(1, &m_EBO);
+    if (m_tintVBO) glDeleteBuffers(1, &m_tintVBO);
+}
+
+void StaticBatch::initializeGL() {
+    if (m_glInitialized) return;
+    initializeOpenGLFunctions();
+    glGenVertexArrays(1, &m_VAO);
+    glGenBuffers(1, &m_VBO);
+    glGenBuffers(1, &m_EBO);
+    glGenBuffers(1, &m_tintVBO);
+    m_glInitialized = true;
+}
+
+bool StaticBatch::build(const Mesh &source, const std::vector<QMatrix4x4> &transforms) {
+    // Taken from the resident mesh, no second read of the file
+    const std::vector<Vertex> &sourceVertices = source.getKeptVertices();
+    const std::vector<unsigned int> &sourceIndices = source.getKeptIndices();
+    if (sourceIndices.empty()) {
+        qDebug() << "Static batch source has no kept geometry:" << source.getPath();
+        clear();
+        return false;
+    }
+
+    size_t copies = transforms.size();
+    m_vertices.clear();
+    m_indices.clear();
+    m_vertices.reserve(copies * sourceVertices.size());
+    m_indices.reserve(copies * sourceIndices.size());
+    m_bounds = Aabb();
+
+    for (const QMatrix4x4 &transform : transforms) {
+        unsigned int base = unsigned(m_vertices.size());
+        QMatrix3x3 normalMatrix = NormalMatrix::of(transform);
+        const float *n = normalMatrix.constData();  // column major
+
+        for (const Vertex &vertex : sourceVertices) {
+            Vertex v = vertex;
+            v.position = transform.map(vertex.position);
+            const QVector3D &normal = vertex.normal;
+            v.normal = QVector3D(n[0] * normal.x() + n[3] * normal.y() + n[6] * normal.z(),
+                                 n[1] * normal.x() + n[4] * normal.y() + n[7] * normal.z(),
+                                 n[2] * normal.x() + n[5] * normal.y() + n[8] * normal.z()).normalized();
+            m_bounds.expand(v.position);
+            m_vertices.push_back(v);
+        }
+        for (unsigned int index : sourceIndices) {
+            m_indices.push_back(base + index);
+        }
+    }
+
+    m_copyCount = int(copies);
+    m_verticesPerCopy = sourceVertices.size();
+    m_tints.assign(copies, QVector4D(1.0f, 1.0f, 1.0f, 1.0f));
+    m_geometryDirty = true;
+    m_tintsDirty = true;
+    return true;
+}
+
+void StaticBatch::setTints(const std::vector<QVector4D> &tints) {
+    if (tints.size() != size_t(m_copyCount)) return;
+    m_tints = tints;
+    m_tintsDirty = true;
+}
+
+void StaticBatch::clear() {
+    m_vertices.clear();
+    m_indices.clear();
+    m_tints.clear();
+    m_copyCount = 0;
+    m_verticesPerCopy = 0;
+    m_indexCount = 0;
+    m_bounds = Aabb();
+    m_geometryDirty = false;
+    m_tintsDirty = false;
+}
+
+void StaticBatch::uploadGeometry() {
+    // The element buffer binding is VAO state, so the VAO goes first
+    GLStateCache::instance().bindVertexArray(m_VAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(m_vertices.size() * sizeof(Vertex)), m_vertices.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoords));
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, GLsizeiptr(m_indices.size() * sizeof(unsigned int)), m_indices.data(),
+                 GL_STATIC_DRAW);
+    m_indexCount = GLsizei(m_indices.size());
+
+    // Tints advance per vertex here, not per instance like InstanceBatch
+    glBindBuffer(GL_ARRAY_BUFFER, m_tintVBO);
+    glEnableVertexAttribArray(7);
+    glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, sizeof(QVector4D), (void*)0);
+    glVertexAttribDivisor(7, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // Nothing reads these again, a rebuild starts over from the source mesh
+    m_vertices.clear();
+    m_vertices.shrink_to_fit();
+    m_indices.clear();
+    m_indices.shrink_to_fit();
+    m_geometryDirty = false;
+}
+
+void StaticBatch::uploadTints() {
+    size_t perCopy = m_verticesPerCopy;
+    std::vector<QVector4D> vertexTints;
+    vertexTints.reserve(m_tints.size() * perCopy);
+    for (const QVector4D &tint : m_tints) {
+        vertexTints.insert(vertexTints.end(), perCopy, tint);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_tintVBO);
+    glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(vertexTints.size() * sizeof(QVector4D)), vertexTints.data(),
+                 GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    m_tintsDirty = false;
+}
+
+bool StaticBatch::draw(Mesh *material, Shader *shader) {
+    if (!material || !material->isResident() || m_copyCount == 0) return false;
+
+    initializeGL();
+    if (m_geometryDirty) uploadGeometry();
+    if (m_tintsDirty) uploadTints();
+
+    // Positions are already in world space, material still comes from the mesh
+    const ModelUniforms &uniforms = shader->handles<ModelUniforms>();
+    shader->bind();
+    shader->set(uniforms.instanced, false);
+    material->applyMaterial(shader);
+    shader->set(uniforms.compactVertices, false);
+    shader->set(uniforms.bakedTint, true);
+    shader->set(uniforms.model, QMatrix4x4());
+    shader->set(uniforms.normalMatrix, QMatrix3x3());
+
+    GLStateCache::instance().bindVertexArray(m_VAO);
+    glDrawElements(GL_TRIANGLES, m_indexCount, GL_UNSIGNED_INT, 0);
+
+    shader->set(uniforms.bakedTint, false);
+    return true;
+}
@@ -0,0 +1,74 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_STATICBATCH_H
+#define GARDEN_SIMULATION_STATICBATCH_H
+
+#pragma once
+#include <QMatrix4x4>
+#include <QOpenGLFunctions_3_3_Core>
+#include <QVector4D>
+#include <vector>
+#include "model/meshdata.h"
+#include "renderer/frustum.h"
+#include "renderer/mesh.h"
+#include "renderer/shader.h"
+
+// Copies of one mesh baked into world space and merged into a single vertex/index buffer,
+// so a layer that never moves (the beds) is one glDrawElements with no per instance work
+// Meant for when the transforms only change with the garden size, rebuilding is a full re-upload
+// The tint is a separate per vertex stream on location 7 so moisture changes skip the geometry
+// Like InstanceBatch the CPU side needs no context, draw uploads whatever changed
+class StaticBatch : protected QOpenGLFunctions_3_3_Core {
+
+public:
+    StaticBatch() = default;
+    ~StaticBatch();
+
+    StaticBatch(const StaticBatch&) = delete;
+    StaticBatch& operator=(const StaticBatch&) = delete;
+
+    // Bakes a copy of source's geometry per transform, source needs keepGeometry() set before it went resident
+    bool build(const Mesh &source, const std::vector<QMatrix4x4> &transforms);
+
+    // One tint per transform, in build order
+    void setTints(const std::vector<QVector4D> &tints);
+
+    void clear();
+
+    // material supplies textures and the material block, its own geometry isn't used
+    // Returns false if there was nothing to draw
+    bool draw(Mesh *material, Shader *shader);
+
+    bool isEmpty() const { return m_copyCount == 0; }
+    int copyCount() const { return m_copyCount; }
+    const Aabb& bounds() const { return m_bounds; }
+    GLuint vertexArray() const { return m_VAO; }
+
+private:
+    // Merged copies waiting for upload, freed once they're on the GL
+    std::vector<Vertex> m_vertices;
+    std::vector<unsigned int> m_indices;
+    std::vector<QVector4D> m_tints;  // per copy, expanded per vertex on upload
+
+    int m_copyCount = 0;
+    size_t m_verticesPerCopy = 0;
+    GLsizei m_indexCount = 0;
+    Aabb m_bounds;
+
+    GLuint m_VAO = 0;
+    GLuint m_VBO = 0;
+    GLuint m_EBO = 0;
+    GLuint m_tintVBO = 0;
+    bool m_geometryDirty = false;
+    bool m_tintsDirty = false;
+    bool m_glInitialized = false;
+
+    void initializeGL();
+    void uploadGeometry();
+    void uploadTints();
+};
+
+
+#endif //GARDEN_SIMULATION_STATICBATCH_H
@@ -0,0 +1,109 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include <QDebug>
+#include <cstring>
+#include "streambuffer.h"
+#include "glstatecache.h"
+
+StreamBuffer::StreamBuffer(GLsizeiptr capacity) : m_capacity(capacity) {
+}
+
+StreamBuffer::~StreamBuffer() {
+    if (!m_glInitialized) return;
+    for (const Frame &frame : m_frames) glDeleteSync(frame.fence);
+    GLStateCache::instance().forgetUniformBuffer(m_buffer);
+    glDeleteBuffers(1, &m_buffer);
+}
+
+void StreamBuffer::initializeGL() {
+    initializeOpenGLFunctions();
+    glGenBuffers(1, &m_buffer);
+
+    // Uploads go through the copy target, which no VAO or block binding looks at
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, m_capacity, nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &m_uniformAlignment);
+    m_glInitialized = true;
+}
+
+GLsizeiptr StreamBuffer::uniformAlignment() {
+    if (!m_glInitialized) initializeGL();
+    return m_uniformAlignment;
+}
+
+GLintptr StreamBuffer::upload(const void *data, GLsizeiptr size, GLsizeiptr alignment) {
+    if (!m_glInitialized) initializeGL();
+    if (size <= 0 || size > m_capacity) return -1;
+
+    // Aligned start, or back to 0 when the slice would run past the end
+    GLsizeiptr start = (m_head + alignment - 1) / alignment * alignment;
+    if (start + size > m_capacity) start = 0;
+    GLsizeiptr needed = (start >= m_head ? start - m_head : m_capacity - m_head) + size;
+
+    // Free space is whatever the fenced frames and this one don't cover
+    retireFinished();
+    while (m_used + needed > m_capacity) {
+        if (!retireOldest()) {
+            // This frame alone has filled the ring. Orphaning would pull the storage out from under
+            // slices this frame already bound, so the upload is refused and the ring needs to be bigger
+            ++m_stats.overflows;
+            return -1;
+        }
+    }
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+    void *target = glMapBufferRange(GL_COPY_WRITE_BUFFER, start, size,
+                                    GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+    if (target) {
+        std::memcpy(target, data, size_t(size));
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    } else {
+        qDebug() << "StreamBuffer: map failed, uploading" << size << "bytes the slow way";
+        glBufferSubData(GL_COPY_WRITE_BUFFER, start, size, data);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    m_head = start + size;
+    m_used += needed;
+    m_frameBytes += needed;
+    m_stats.bytes += size;
+    ++m_stats.uploads;
+    return start;
+}
+
+void StreamBuffer::endFrame() {
+    if (!m_glInitialized || m_frameBytes == 0) return;
+    m_frames.push_back({glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), m_frameBytes});
+    m_frameBytes = 0;
+}
+
+void StreamBuffer::retireFinished() {
+    // Polls only, anything still running stays fenced
+    while (!m_frames.empty()) {
+        GLenum status = glClientWaitSync(m_frames.front().fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) return;
+        glDeleteSync(m_frames.front().fence);
+        m_used -= m_frames.front().bytes;
+        m_frames.pop_front();
+    }
+}
+
+bool StreamBuffer::retireOldest() {
+    if (m_frames.empty()) return false;
+
+    // The GPU is a whole ring behind, nothing to do but wait for it
+    ++m_stats.waits;
+    const Frame &oldest = m_frames.front();
+    while (true) {
+        GLenum status = glClientWaitSync(oldest.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+        if (status != GL_TIMEOUT_EXPIRED) break;
+    }
+    glDeleteSync(oldest.fence);
+    m_used -= oldest.bytes;
+    m_frames.pop_front();
+    return true;
+}
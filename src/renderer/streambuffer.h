@@ -0,0 +1,73 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_STREAMBUFFER_H
+#define GARDEN_SIMULATION_STREAMBUFFER_H
+
+#pragma once
+#include <QOpenGLFunctions_3_3_Core>
+#include <deque>
+
+// Ring of per-frame GPU data (uniform blocks, vertices written every frame) in one fixed buffer
+// Each upload maps its aligned slice with GL_MAP_UNSYNCHRONIZED_BIT, so the driver never waits
+// on draws still reading older slices. endFrame fences what the frame wrote, and a slice is only
+// reused once its fence has passed. If the GPU is a whole ring behind, upload waits on the oldest
+// fence. The storage is allocated once and never grows or gets orphaned, so size it for a few frames
+// Needs the context current for everything but the constructor
+class StreamBuffer : protected QOpenGLFunctions_3_3_Core {
+
+public:
+    // Fence waits are uploads that stalled, overflows ones that didn't fit, both should stay at 0
+    struct Stats {
+        qint64 bytes = 0;
+        int uploads = 0;
+        int waits = 0;
+        int overflows = 0;
+    };
+
+    explicit StreamBuffer(GLsizeiptr capacity);
+    ~StreamBuffer();
+
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    // Copies size bytes into the ring at a multiple of alignment and returns that offset into
+    // buffer(), -1 if it doesn't fit next to what this frame already uploaded
+    GLintptr upload(const void *data, GLsizeiptr size, GLsizeiptr alignment = 16);
+
+    // Fences everything uploaded since the last call, once per frame after its draws
+    void endFrame();
+
+    GLuint buffer() const { return m_buffer; }
+
+    // Uniform blocks bound from the ring have to start at this, usually 256
+    GLsizeiptr uniformAlignment();
+
+    const Stats& stats() const { return m_stats; }
+    void resetStats() { m_stats = Stats(); }
+
+private:
+    // What a frame wrote, bytes counts the alignment and wrap padding too
+    struct Frame {
+        GLsync fence;
+        GLsizeiptr bytes;
+    };
+
+    GLsizeiptr m_capacity;
+    GLuint m_buffer = 0;
+    GLsizeiptr m_head = 0;        // next free byte
+    GLsizeiptr m_used = 0;        // fenced frames plus the current one, from the oldest fence to head
+    GLsizeiptr m_frameBytes = 0;  // current frame's share of m_used
+    std::deque<Frame> m_frames;   // oldest first
+    GLint m_uniformAlignment = 0;
+    bool m_glInitialized = false;
+    Stats m_stats;
+
+    void initializeGL();
+    void retireFinished();
+    bool retireOldest();
+};
+
+
+#endif //GARDEN_SIMULATION_STREAMBUFFER_H
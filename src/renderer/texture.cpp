@@ -0,0 +1,239 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QtGui/QImage>
+#include <cstring>
+#include "texture.h"
+#include "glstatecache.h"
+
+// Not in every platform's GL headers
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_RG_RGTC2
+#define GL_COMPRESSED_RG_RGTC2 0x8DBD
+#endif
+
+namespace {
+
+GLenum internalFormatFor(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        case TextureFormat::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case TextureFormat::BC5: return GL_COMPRESSED_RG_RGTC2;
+        case TextureFormat::RGBA8: break;
+    }
+    return GL_RGBA;
+}
+
+const char* formatName(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::BC1: return "BC1";
+        case TextureFormat::BC3: return "BC3";
+        case TextureFormat::BC5: return "BC5";
+        case TextureFormat::RGBA8: break;
+    }
+    return "RGBA8";
+}
+
+}
+
+bool CompressionSupport::supports(TextureFormat format) const {
+    switch (format) {
+        case TextureFormat::BC1:
+        case TextureFormat::BC3:
+            return s3tc;
+        case TextureFormat::BC5:
+            return rgtc;
+        case TextureFormat::RGBA8:
+            break;
+    }
+    return true;
+}
+
+Texture::Texture(const QString &path) : m_id(0), m_path(path) {
+    // GL functions are resolved in upload, a Texture can be created before the context is current
+}
+
+Texture::~Texture() {
+    if (m_id) {
+        GLStateCache::instance().forgetTexture(m_id);
+        glDeleteTextures(1, &m_id);
+    }
+}
+
+std::vector<MipLevel> TexturePayload::levels() const {
+    std::vector<MipLevel> result;
+    if (cached) {
+        for (int i = 0; i < cached->levelCount(); ++i) {
+            result.push_back(cached->level(i));
+        }
+        return result;
+    }
+    for (const QImage &image : images) {
+        result.push_back({image.width(), image.height(), image.constBits(), size_t(image.sizeInBytes())});
+    }
+    return result;
+}
+
+bool Texture::load() {
+    TexturePayload payload;
+    return loadData(m_path, payload) && upload(payload);
+}
+
+bool Texture::loadData(const QString &path, TexturePayload &payload, const CompressionSupport &compression) {
+    QElapsedTimer timer;
+    timer.start();
+
+    // Offline compressed copy first, a quarter to an eighth of the size to map and upload
+    auto baked = std::make_unique<BakedTexture>();
+    if (baked->open(BakedTexture::bakedPathFor(path))) {
+        if (!baked->isUpToDate(path)) {
+            qDebug() << "Compressed texture is stale, rerun garden_bake:" << BakedTexture::bakedPathFor(path);
+        } else if (!compression.supports(baked->format())) {
+            qDebug() << "Context can't sample" << formatName(baked->format()) << "falling back for" << path;
+        } else {
+            payload.cached = std::move(baked);
+            qDebug() << "Mapped" << formatName(payload.format()) << "texture" << path << "with"
+                     << payload.cached->levelCount() << "levels in" << timer.nsecsElapsed() / 1000 << "us";
+            return true;
+        }
+    }
+
+    bool useCache = BakedTexture::isEnabled();
+    QString cachePath = useCache ? BakedTexture::cachePathFor(path) : QString();
+
+    if (useCache) {
+        auto cached = std::make_unique<BakedTexture>();
+        if (cached->open(cachePath) && cached->isUpToDate(path)) {
+            payload.cached = std::move(cached);
+            qDebug() << "Mapped cached texture" << path << "with" << payload.cached->levelCount()
+                     << "levels in" << timer.nsecsElapsed() / 1000 << "us";
+            return true;
+        }
+    }
+
+    QImage image;
+    if (!decode(path, image)) {
+        return false;
+    }
+
+    if (!useCache) {
+        // Just level 0, glGenerateMipmap does the rest like before the cache existed
+        payload.images.push_back(image);
+        qDebug() << "Decoded texture" << path << "in" << timer.nsecsElapsed() / 1000 << "us (cache disabled)";
+        return true;
+    }
+
+    payload.images = BakedTexture::buildMipChain(image);
+    if (!BakedTexture::write(cachePath, path, payload.images)) {
+        qDebug() << "Couldn't write texture cache" << cachePath;
+    }
+    qDebug() << "Decoded texture" << path << "and built" << payload.images.size() << "levels in"
+             << timer.nsecsElapsed() / 1000 << "us";
+    return true;
+}
+
+bool Texture::decode(const QString &path, QImage &image) {
+    qDebug() << "Starting texture load from:" << path;
+
+    image = QImage(path);
+    if (image.isNull()) {
+        qDebug() << "Failed to load texture image from:" << path;
+        qDebug() << "Current working directory:" << QDir::currentPath();
+        return false;
+    }
+
+    // Before conversion
+    qDebug() << "Original image format:" << image.format();
+    qDebug() << "Original image size:" << image.size();
+
+    // Convert and flip image, same layout garden_bake stores
+    image = BakedTexture::prepareLevel0(image);
+    return true;
+}
+
+bool Texture::upload(const TexturePayload &payload, GLuint pixelBuffer) {
+    std::vector<MipLevel> levels = payload.levels();
+    if (levels.empty()) return false;
+
+    QOpenGLFunctions_3_3_Core::initializeOpenGLFunctions();
+
+    glGenTextures(1, &m_id);
+    GLStateCache::instance().bindTexture(0, m_id);
+
+    // Every level goes into the pixel buffer back to back, then each glTexImage2D reads its offset
+    std::vector<const uchar*> sources;
+    for (const MipLevel &level : levels) {
+        sources.push_back(level.pixels);
+    }
+
+    if (pixelBuffer) {
+        // Orphan the buffer so a previous upload still in flight doesn't stall this one
+        size_t total = 0;
+        for (const MipLevel &level : levels) {
+            total += level.size;
+        }
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, GLsizeiptr(total), nullptr, GL_STREAM_DRAW);
+        auto *mapped = static_cast<uchar*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, GLsizeiptr(total),
+                                                            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+        if (mapped) {
+            size_t offset = 0;
+            for (size_t i = 0; i < levels.size(); ++i) {
+                std::memcpy(mapped + offset, levels[i].pixels, levels[i].size);
+                sources[i] = reinterpret_cast<const uchar*>(offset);  // offset into the bound buffer
+                offset += levels[i].size;
+            }
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        } else {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            pixelBuffer = 0;
+        }
+    }
+
+    TextureFormat format = payload.format();
+    for (size_t i = 0; i < levels.size(); ++i) {
+        if (format == TextureFormat::RGBA8) {
+            glTexImage2D(GL_TEXTURE_2D, GLint(i), GL_RGBA, levels[i].width, levels[i].height, 0,
+                         GL_RGBA, GL_UNSIGNED_BYTE, sources[i]);
+        } else {
+            glCompressedTexImage2D(GL_TEXTURE_2D, GLint(i), internalFormatFor(format),
+                                   levels[i].width, levels[i].height, 0, GLsizei(levels[i].size), sources[i]);
+        }
+    }
+
+    if (pixelBuffer) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+
+    // Set texture parameters
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    if (levels.size() > 1) {
+        // Whole chain came from the cache, nothing left for the driver to build
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, GLint(levels.size() - 1));
+    } else {
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+
+    // Check for OpenGL errors
+    GLenum err = glGetError();
+    if (err != GL_NO_ERROR) {
+        qDebug() << "OpenGL error after texture load:" << err;
+    }
+
+    qDebug() << "Successfully created texture with ID:" << m_id << "levels:" << levels.size()
+             << "format:" << formatName(format);
+    return true;
+}
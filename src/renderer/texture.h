@@ -0,0 +1,74 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_TEXTURE_H
+#define GARDEN_SIMULATION_TEXTURE_H
+
+#pragma once
+#include <QImage>
+#include <QString>
+#include <QOpenGLFunctions_3_3_Core>
+#include <memory>
+#include <vector>
+#include "model/bakedtexture.h"
+
+// Everything a texture needs before it touches the GL, built off the GL thread by AssetLoader
+// Either a mapped cache file with the whole mip chain, or decoded images (one level when the
+// cache is off, the driver builds the rest then)
+struct TexturePayload {
+    std::vector<QImage> images;
+    std::unique_ptr<BakedTexture> cached;
+
+    TextureFormat format() const { return cached ? cached->format() : TextureFormat::RGBA8; }
+    std::vector<MipLevel> levels() const;
+};
+
+// Block compression the current context can sample from
+struct CompressionSupport {
+    bool s3tc = false;  // BC1/BC3, GL_EXT_texture_compression_s3tc
+    bool rgtc = false;  // BC5, core since GL 3.0
+
+    bool supports(TextureFormat format) const;
+};
+
+// GPU texture shared between every mesh that references the same image file
+// Handed out by AssetCache, treat as immutable once loaded
+// Starts out invalid (id 0) and becomes valid once AssetLoader uploads it
+class Texture : protected QOpenGLFunctions_3_3_Core {
+
+public:
+    explicit Texture(const QString &path);
+    ~Texture();
+
+    Texture(const Texture&) = delete;
+    Texture& operator=(const Texture&) = delete;
+
+    // Synchronous load, same as loadData followed by upload on the GL thread
+    bool load();
+
+    // CPU half of loading, safe on any thread
+    // Prefers the block compressed copy from garden_bake when the context supports its format,
+    // then the decoded texture cache, otherwise decodes the image to flipped RGBA8888, builds
+    // the mip chain and writes the cache for next time
+    static bool loadData(const QString &path, TexturePayload &payload,
+                         const CompressionSupport &compression = CompressionSupport());
+
+    // Reads the file and converts to flipped RGBA8888
+    static bool decode(const QString &path, QImage &image);
+
+    // GL half of loading, needs the context current
+    // With a pixel buffer the pixels are staged through it so the driver can copy asynchronously
+    bool upload(const TexturePayload &payload, GLuint pixelBuffer = 0);
+
+    GLuint getId() const { return m_id; }
+    const QString& getPath() const { return m_path; }
+    bool isValid() const { return m_id != 0; }
+
+private:
+    GLuint m_id;
+    QString m_path;
+};
+
+
+#endif //GARDEN_SIMULATION_TEXTURE_H
@@ -0,0 +1,44 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include <cstring>
+#include "uniformblocks.h"
+#include "glstatecache.h"
+
+namespace {
+
+void copyVec3(float *dst, const QVector3D &v, float w) {
+    dst[0] = v.x();
+    dst[1] = v.y();
+    dst[2] = v.z();
+    dst[3] = w;
+}
+
+}
+
+FrameBlock::FrameBlock(const QMatrix4x4 &viewMatrix, const QMatrix4x4 &projectionMatrix, const QVector3D &cameraPos,
+                       const QVector3D &sunPos, const QVector3D &sunColor, float seconds) {
+    // Column major on both sides, so the matrices copy straight in
+    std::memcpy(view, viewMatrix.constData(), sizeof(view));
+    std::memcpy(projection, projectionMatrix.constData(), sizeof(projection));
+    copyVec3(viewPos, cameraPos, 1.0f);
+    copyVec3(lightPos, sunPos, 1.0f);
+    copyVec3(lightColor, sunColor, 1.0f);
+    time = seconds;
+    padding[0] = padding[1] = padding[2] = 0.0f;
+    clusters[0] = clusters[1] = clusters[2] = clusters[3] = 0.0f;
+}
+
+MaterialBlock::MaterialBlock(const Material &material) {
+    copyVec3(ambient, material.ambient, 1.0f);
+    copyVec3(diffuse, material.diffuse, 1.0f);
+    copyVec3(specular, material.specular, material.shininess);
+}
+
+bool FrameUniformBuffer::update(const FrameBlock &frame, StreamBuffer &stream) {
+    GLintptr offset = stream.upload(&frame, sizeof(FrameBlock), stream.uniformAlignment());
+    if (offset < 0) return false;
+    GLStateCache::instance().bindUniformBufferRange(FrameBlockBinding, stream.buffer(), offset, sizeof(FrameBlock));
+    return true;
+}
@@ -0,0 +1,61 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_UNIFORMBLOCKS_H
+#define GARDEN_SIMULATION_UNIFORMBLOCKS_H
+
+#pragma once
+#include <QMatrix4x4>
+#include <QOpenGLFunctions_3_3_Core>
+#include <QVector3D>
+#include "model/meshdata.h"
+#include "renderer/streambuffer.h"
+
+// Binding points every program's blocks are attached to after linking (see Shader::markLinked)
+enum UniformBlockBinding : GLuint {
+    FrameBlockBinding = 0,
+    MaterialBlockBinding = 1
+};
+
+// std140 layout of the Frame block, keep in step with the GLSL
+// layout (std140) uniform Frame { mat4 view; mat4 projection; vec4 viewPos; vec4 lightPos; vec4 lightColor; float time;
+//                                  vec4 clusters; };
+struct FrameBlock {
+    float view[16];
+    float projection[16];
+    float viewPos[4];     // xyz
+    float lightPos[4];    // xyz, the sun
+    float lightColor[4];  // rgb
+    float time;           // seconds since the widget was created
+    float padding[3];
+    float clusters[4];    // depth slice scale and bias, point light count (see LightClusters), zero without lights
+
+    FrameBlock(const QMatrix4x4 &viewMatrix, const QMatrix4x4 &projectionMatrix, const QVector3D &cameraPos,
+               const QVector3D &sunPos, const QVector3D &sunColor, float seconds);
+};
+
+// std140 layout of the Material block
+// layout (std140) uniform Material { vec4 ambient; vec4 diffuse; vec4 specular; } material;
+struct MaterialBlock {
+    float ambient[4];
+    float diffuse[4];
+    float specular[4];  // w is the shininess
+
+    explicit MaterialBlock(const Material &material);
+};
+
+static_assert(sizeof(FrameBlock) == 208, "std140 Frame block");
+static_assert(sizeof(MaterialBlock) == 48, "std140 Material block");
+
+// The Frame block, written into the frame's StreamBuffer slice and bound from there, read by every program
+// A new slice each frame means the update never waits on draws that still read the last one
+class FrameUniformBuffer {
+
+public:
+    // Needs the GL context current, false if the ring had no room
+    bool update(const FrameBlock &frame, StreamBuffer &stream);
+};
+
+
+#endif //GARDEN_SIMULATION_UNIFORMBLOCKS_H
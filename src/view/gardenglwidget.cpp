@@ -3,17 +3,17 @@
 //
 
 #include "gardenglwidget.h"
+#include "renderer/assetcache.h"
 #include <QMouseEvent>
 #include <QMimeData>
+#include <QScreen>
+#include <algorithm>
 
 
 GardenGLWidget::GardenGLWidget(GardenController* controller, QWidget* parent)
         : QOpenGLWidget(parent)
         , m_controller(controller)
         , m_camera(std::make_unique<Camera>())
-        , m_gridShader(nullptr)
-        , m_modelShader(nullptr)
-        , m_sunShader(nullptr)
         , m_temperature(60.0f)  // Default temperature (°F)
         , m_moisture(0.5f)      // Default moisture (50%)
 {
@@ -30,131 +30,43 @@ GardenGLWidget::GardenGLWidget(GardenController* controller, QWidget* parent)
             this, &GardenGLWidget::onTemperatureChanged);
     connect(controller, &GardenController::moistureChanged,
             this, &GardenGLWidget::onMoistureChanged);
+    connect(controller, &GardenController::lightsChanged,
+            this, &GardenGLWidget::onLightsChanged);
+    connect(controller, &GardenController::gardenLoaded,
+            this, &GardenGLWidget::onGardenLoaded);
+
+    m_picker.setGridSize(controller->getModel()->getGridSize());
 }
 
 
 
+GardenGLWidget::~GardenGLWidget() {
+    // The scene's buffers and programs go with the context, so it has to be current
+    makeCurrent();
+    m_scene.reset();
+    doneCurrent();
+}
+
 void GardenGLWidget::initializeGL() {
     initializeOpenGLFunctions();
-    glClearColor(0.529f, 0.808f, 0.922f, 1.0f);
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    initializeShaders();
-    initializeGridLines();
-    initializeModels();
-    initializeGridCells();
-    initializeSun();
-}
-
-void GardenGLWidget::initializeSun() {
-    // Create VAO and VBO for the sun
-    glGenVertexArrays(1, &m_sunVAO);
-    glGenBuffers(1, &m_sunVBO);
-}
-
-void GardenGLWidget::initializeShaders() {
-    // Create and compile grid shader
-    m_gridShader = std::make_unique<Shader>(
-            "/Users/raphaelrusso/CLionProjects/garden_simulation/shaders/grid.vert",
-            "/Users/raphaelrusso/CLionProjects/garden_simulation/shaders/grid.frag"
-    );
-    if (!m_gridShader->compile()) {
-        qDebug() << "Failed to compile grid shader";
-        return;
-    }
-    qDebug() << "Grid shader compiled successfully";
-
-    // Create and compile model shader
-    m_modelShader = std::make_unique<Shader>(
-            "/Users/raphaelrusso/CLionProjects/garden_simulation/shaders/model.vert",
-            "/Users/raphaelrusso/CLionProjects/garden_simulation/shaders/model.frag"
-    );
-    if (!m_modelShader->compile()) {
-        qDebug() << "Failed to compile model shader";
-        return;
-    }
-    qDebug() << "Model shader compiled successfully";
-
-    m_sunShader = std::make_unique<Shader>(
-            "/Users/raphaelrusso/CLionProjects/garden_simulation/shaders/sun.vert",
-            "/Users/raphaelrusso/CLionProjects/garden_simulation/shaders/sun.frag"
-    );
-    if (!m_sunShader->compile()) {
-        qDebug() << "Failed to compile sun shader";
-        return;
-    }
-    qDebug() << "Plant shader compiled successfully";
-}
-
-void GardenGLWidget::initializeGridLines() {
-    std::vector<float> gridVertices;
-    for (int i = 0; i <= GRID_SIZE; ++i) {
-        // Horizontal lines
-        gridVertices.push_back(0.0f);      // x start
-        gridVertices.push_back(0.0f);      // y
-        gridVertices.push_back(float(i));  // z
-        gridVertices.push_back(0.0f);      // normal x
-        gridVertices.push_back(1.0f);      // normal y
-        gridVertices.push_back(0.0f);      // normal z
-
-        gridVertices.push_back(float(GRID_SIZE));  // x end
-        gridVertices.push_back(0.0f);             // y
-        gridVertices.push_back(float(i));         // z
-        gridVertices.push_back(0.0f);             // normal x
-        gridVertices.push_back(1.0f);             // normal y
-        gridVertices.push_back(0.0f);             // normal z
-
-        // Vertical lines
-        gridVertices.push_back(float(i));  // x
-        gridVertices.push_back(0.0f);      // y
-        gridVertices.push_back(0.0f);      // z start
-        gridVertices.push_back(0.0f);      // normal x
-        gridVertices.push_back(1.0f);      // normal y
-        gridVertices.push_back(0.0f);      // normal z
-
-        gridVertices.push_back(float(i));         // x
-        gridVertices.push_back(0.0f);             // y
-        gridVertices.push_back(float(GRID_SIZE)); // z end
-        gridVertices.push_back(0.0f);             // normal x
-        gridVertices.push_back(1.0f);             // normal y
-        gridVertices.push_back(0.0f);             // normal z
-    }
-
-    glGenVertexArrays(1, &m_gridVAO);
-    glGenBuffers(1, &m_gridVBO);
-
-    glBindVertexArray(m_gridVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, m_gridVBO);
-    glBufferData(GL_ARRAY_BUFFER, gridVertices.size() * sizeof(float),
-                 gridVertices.data(), GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
 
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float),
-                          (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-}
+    // Repaint whenever a loader thread has something ready, paintGL does the upload
+    connect(&AssetCache::instance().loader(), &AssetLoader::assetStaged,
+            this, [this]() { m_repaint.markDirty(RepaintScheduler::Assets); }, Qt::QueuedConnection);
 
-void GardenGLWidget::initializeModels() {
-    m_bedModel = std::make_unique<Model>();
-    if (!m_bedModel->loadModel("/Users/raphaelrusso/CLionProjects/garden_simulation/models/bed.obj")) {
-        qDebug() << "Failed to load garden bed model";
-        return;
+    // Bursts are held to one frame per refresh of this screen
+    if (QScreen *display = screen(); display && display->refreshRate() > 0.0) {
+        m_repaint.setFrameInterval(qint64(1e9 / display->refreshRate()));
     }
-}
+    m_requestedLighting = SceneRenderer::sunLighting(m_temperature);
 
-void GardenGLWidget::initializeGridCells() {
-    m_grid.resize(GRID_SIZE, std::vector<GridCell>(GRID_SIZE));
-    for (int x = 0; x < GRID_SIZE; ++x) {
-        for (int z = 0; z < GRID_SIZE; ++z) {
-            m_grid[x][z].hasBed = true;
-            m_grid[x][z].position = QVector3D(x, 0, z);
-            m_grid[x][z].moisture = m_moisture;
-        }
-    }
+    m_scene = std::make_unique<SceneRenderer>();
+    m_scene->initialize();
+    m_scene->setTemperature(m_temperature);
+    m_scene->setMoisture(m_moisture);
+    m_scene->syncPlants(*m_controller->getModel());
+    m_scene->setLights(m_controller->getModel()->getLights());
+    m_scene->profiler().setEnabled(m_profiling);
 }
 
 void GardenGLWidget::resizeGL(int w, int h) {
@@ -166,169 +78,89 @@ void GardenGLWidget::resizeGL(int w, int h) {
 
 
 void GardenGLWidget::paintGL() {
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-    QMatrix4x4 view = m_camera->getViewMatrix();
-    QMatrix4x4 projection = m_camera->getProjectionMatrix();
-
-    // Draw grid
-    m_gridShader->bind();
-    m_gridShader->setMat4("view", view);
-    m_gridShader->setMat4("projection", projection);
-
-    // Grid isn't affected by the sun position or temperature / color
-    QVector3D lightPos(5.0f, 5.0f, 5.0f);
-    QVector3D lightColor(1.0f, 1.0f, 1.0f);
-    m_gridShader->setVec3("lightPos", lightPos);
-    m_gridShader->setVec3("lightColor", lightColor);
-    m_gridShader->setVec3("gridColor", QVector3D(0.8f, 0.8f, 0.8f));
-    m_gridShader->setFloat("ambientStrength", 0.3f);
-
-    QMatrix4x4 model;
-    m_gridShader->setMat4("model", model);
-    glBindVertexArray(m_gridVAO);
-    glDrawArrays(GL_LINES, 0, (GRID_SIZE + 1) * 4);
-
-    renderSun(view, projection);
-
-    // Update light properties based on sun
-    lightColor = calculateSunColor(m_temperature);
-
-    // Use sun position and color for lighting other objects
-    m_modelShader->bind();
-    m_modelShader->setMat4("view", view);
-    m_modelShader->setMat4("projection", projection);
-    m_modelShader->setVec3("lightPos", m_sunPosition);
-    m_modelShader->setVec3("lightColor", lightColor);
-    m_modelShader->setVec3("viewPos", m_camera->getPosition());
-    m_modelShader->setBool("isPreview", false); // Beds and placed plants don't have any change with the preview state
-
-    const GardenModel* gardenModel = m_controller->getModel();
-    for (int x = 0; x < gardenModel->getGridSize(); ++x) {
-        for (int z = 0; z < gardenModel->getGridSize(); ++z) {
-            QPoint pos(x, z);
-
-            // Draw bed
-            QVector3D position(x + 0.5f, 0.0f, z + 0.5f);
-            m_bedModel->setPosition(position);
-            m_bedModel->draw(m_modelShader.get());
+    m_repaint.beginFrame();
+    m_gpuTimer.begin();
 
-            // Draw plant if present
-            Plant* plant = gardenModel->getPlant(pos);
-            if (plant) {
-                plant->getModel()->setPosition(position);
-                plant->getModel()->draw(m_modelShader.get());
-            }
-        }
+    // Upload whatever finished loading, leftovers go in the next frame
+    if (AssetCache::instance().processUploads(UPLOAD_BUDGET_NS) > 0) {
+        m_repaint.markDirty(RepaintScheduler::Assets);
     }
+    refreshProvisionalPickBounds();
 
-    // Draw preview model if active
-    if (m_isPreviewActive && m_previewModel) {
-        // Temporarily modify depth testing for transparent preview
-        glDepthFunc(GL_LEQUAL);  // Change depth function
-        glDepthMask(GL_FALSE);   // Don't write to depth buffer
+    m_scene->render(*m_camera, m_controller->getModel()->getGridSize(),
+                    [this](RenderQueue &queue, const Frustum &frustum) { queueOverlays(queue, frustum); });
+    m_gpuTimer.end();
+}
 
-        m_modelShader->bind();
-        m_modelShader->setBool("isPreview", true);
+void GardenGLWidget::queueOverlays(RenderQueue &queue, const Frustum &frustum) {
+    const GardenModel* gardenModel = m_controller->getModel();
 
+    // Preview model if active, see through on top of the scene
+    if (m_isPreviewActive && m_previewModel && frustum.isVisible(m_previewModel->getWorldBounds())) {
         // Convert world position to grid position for validity check
         QPoint gridPos(std::floor(m_previewPosition.x()),
                        std::floor(m_previewPosition.z()));
 
-        // Check if position is within grid bounds
-        bool isWithinGrid = (gridPos.x() >= 0 && gridPos.x() < GRID_SIZE &&
-                             gridPos.y() >= 0 && gridPos.y() < GRID_SIZE);
-
-
-        // Check if position is valid for placement
-        bool isValidPlacement = isWithinGrid &&
-                                //m_grid[gridPos.x()][gridPos.y()].hasBed &&
-                                //!m_grid[gridPos.x()][gridPos.y()].plant;
-                                gardenModel->canPlacePlant(gridPos);
+        // Inside the garden and free, the same check the drop goes through
+        bool isValidPlacement = gardenModel->canPlacePlant(gridPos);
 
 
         QVector3D highlightColor = isValidPlacement ?
                                    QVector3D(0.0f, 1.0f, 0.0f) :  // Valid placement
                                    QVector3D(1.0f, 0.0f, 0.0f);   // Invalid placement
 
-        m_modelShader->setVec3("previewColor", highlightColor);
-        m_modelShader->setFloat("previewAlpha", 0.7f);
-
         m_previewModel->setPosition(m_previewPosition);
-        m_previewModel->draw(m_modelShader.get());
-
-        // Reset depth testing to normal
-        glDepthFunc(GL_LESS);
-        glDepthMask(GL_TRUE);
-        m_modelShader->setBool("isPreview", false);
+        DrawPacket preview;
+        preview.pass = RenderPass::Overlay;
+        preview.shader = m_scene->modelShader();
+        preview.mesh = m_previewModel->getMesh();
+        preview.model = m_previewModel->getModelMatrix();
+        preview.overlayColor = QVector4D(highlightColor, 0.7f);
+        preview.depth = m_camera->getPosition().distanceToPoint(m_previewPosition);
+        preview.section = FrameProfiler::Preview;
+        queue.submit(preview);
     }
 
     if (m_deleteModeActive) {
-        // Save current OpenGL state
-        GLint previousDepthFunc;
-        glGetIntegerv(GL_DEPTH_FUNC, &previousDepthFunc);
-        GLboolean depthMask;
-        glGetBooleanv(GL_DEPTH_WRITEMASK, &depthMask);
-
-        // Setup for transparent highlighting
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glDepthFunc(GL_LEQUAL);
-        glDepthMask(GL_FALSE);   // Don't write to depth buffer
-
-        if (m_controller->getModel()->getPlant(m_hoveredCell)) {
-            renderPlantHighlight(m_hoveredCell, QVector3D(1.0f, 1.0f, 0.0f));
-        }
-
-        // Restore previous state
-        glDepthFunc(previousDepthFunc);
-        glDepthMask(depthMask);
-        glDisable(GL_BLEND);
+        queuePlantHighlight(queue, m_hoveredCell, QVector3D(1.0f, 1.0f, 0.0f));
     }
 }
 
-void GardenGLWidget::renderSun(const QMatrix4x4& view, const QMatrix4x4& projection) {
-    // Bind sun shader
-    m_sunShader->bind();
-    m_sunPosition = QVector3D(GRID_SIZE/2.0f, 8.0f, GRID_SIZE/2.0f);  // Center above garden
-
-    // Create model matrix for sun
-    QMatrix4x4 model;
-    model.translate(m_sunPosition);
-    model.scale(1.0f);
-
-    // Set shader uniforms
-    m_sunShader->setMat4("model", model);
-    m_sunShader->setMat4("view", view);
-    m_sunShader->setMat4("projection", projection);
-
-    // Calculate sun color based on temperature
-    QVector3D sunColor = calculateSunColor(m_temperature);
-    float intensity = 1.0f + (m_temperature - 60.0f) / 30.0f;  // Brighter when hotter
+GardenGLWidget::RenderActivity GardenGLWidget::takeActivity() {
+    RenderActivity activity;
+    activity.frames = m_repaint.takeStats();
+    activity.gpuNs = m_gpuTimer.takeElapsedNs();
+    return activity;
+}
 
-    // Clamp intensity
-    intensity = std::max(0.5f, std::min(2.0f, intensity));
+void GardenGLWidget::setProfiling(bool enabled) {
+    m_profiling = enabled;
+    if (!m_scene) return;  // picked up in initializeGL
 
-    m_sunShader->setVec3("sunColor", sunColor);
-    m_sunShader->setFloat("intensity", intensity);
+    // Frames from an earlier look would skew this one
+    m_scene->profiler().setEnabled(enabled);
+    if (enabled) m_scene->profiler().clear();
+}
 
-    // Draw the sun cube
-    drawCube(m_sunVAO, m_sunVBO);
+FrameProfiler::Summary GardenGLWidget::profileSummary() const {
+    return m_scene ? m_scene->profiler().summary() : FrameProfiler::Summary();
+}
 
-    m_sunShader->release();
+bool GardenGLWidget::exportProfile(const QString& path) const {
+    return m_scene && m_scene->profiler().writeCsv(path);
 }
 
 
 void GardenGLWidget::mousePressEvent(QMouseEvent *event) {
     m_lastPos = event->pos();
     if (event->button() == Qt::LeftButton) {
-        QVector3D worldPos = screenToWorld(event->pos());
-        QPoint gridPos(worldPos.x(), worldPos.z());
+        GridPicker::Hit hit = pickAt(event->pos());
 
         if (m_deleteModeActive) {
-            handleDeleteModeClick(gridPos);
-        } else {
-            emit gridClicked(gridPos);
+            // A tall plant in front of the bed the cursor is over is what gets deleted
+            handleDeleteModeClick(hit.target());
+        } else if (hit.cell.x() >= 0) {
+            emit gridClicked(hit.cell);
         }
     }
 
@@ -336,62 +168,72 @@ void GardenGLWidget::mousePressEvent(QMouseEvent *event) {
 void GardenGLWidget::mouseMoveEvent(QMouseEvent *event) {
     QPoint delta = event->pos() - m_lastPos;
 
-    if (m_deleteModeActive) {
-        // Always update hover position in delete mode
-        QPoint newHoveredCell = screenToGrid(event->pos());
-
-        // Only update if the position actually changed
-        if (newHoveredCell != m_hoveredCell) {
-            m_hoveredCell = newHoveredCell;
-
-            qDebug() << "Hovering over cell:" << m_hoveredCell;
-
-            update();
-        }
-    }
-    if (event->buttons() & Qt::RightButton) {
+    // Plain hovering moves nothing on screen
+    if (!delta.isNull() && (event->buttons() & Qt::RightButton)) {
         m_camera->orbit(delta.x(), delta.y());
+        m_repaint.markDirty(RepaintScheduler::Camera);
 
-    } else if (event->buttons() & Qt::MiddleButton) {
+    } else if (!delta.isNull() && (event->buttons() & Qt::MiddleButton)) {
         m_camera->pan(delta.x(), delta.y());
+        m_repaint.markDirty(RepaintScheduler::Camera);
 
     }
+
+    // After the camera move, so the hover is for the view that gets drawn
+    if (m_deleteModeActive) {
+        updateHover(event->pos());
+    }
     m_lastPos = event->pos();
-    update();
 }
 
 void GardenGLWidget::wheelEvent(QWheelEvent *event) {
     float delta = event->angleDelta().y() / 120.f;
     m_camera->zoom(delta);
-    update();
+    m_repaint.markDirty(RepaintScheduler::Camera);
+
+    // The cursor stays put but a different cell ends up under it
+    if (m_deleteModeActive) {
+        updateHover(m_hoverPos);
+    }
 }
 
-QVector3D GardenGLWidget::screenToWorld(const QPoint &screenPos) {
-    // SCreen to normalized device coords (-1 to 1)
-    float x = (2.0 * screenPos.x()) / width() - 1.0f;
-    float y = 1.0  - (2.0f * screenPos.y()) / height();
+void GardenGLWidget::updateHover(const QPoint &screenPos) {
+    // Nothing to redo when neither the cursor nor the camera moved since the last pick
+    if (screenPos == m_hoverPos && m_camera->version() == m_hoverCameraVersion) return;
+    m_hoverPos = screenPos;
+    m_hoverCameraVersion = m_camera->version();
+
+    QPoint newHoveredCell = pickAt(screenPos).target();
+    if (newHoveredCell != m_hoveredCell) {
+        m_hoveredCell = newHoveredCell;
+        m_repaint.markDirty(RepaintScheduler::Overlay);
+    }
+}
 
-    // Ray in clip space
-    QVector4D rayClip(x, y, -1.0f, 1.0f);
-    // Transform to world space with inverse matrices - backwards through pipeline
-    QMatrix4x4 invProjection = m_camera->getProjectionMatrix().inverted();
-    QMatrix4x4 invView = m_camera->getViewMatrix().inverted();
+GridPicker::Hit GardenGLWidget::pickAt(const QPoint &screenPos) const {
+    return m_picker.pick(GridPicker::screenRay(*m_camera, screenPos, size()));
+}
 
-    // Ray direction in world space
+void GardenGLWidget::updatePickBounds(const QPoint &position, const Plant *plant) {
+    // Until the mesh knows its bounds the plant picks as a cell sized box, swapped once it does
+    Aabb bounds = plant->getModel()->getWorldBounds();
+    if (bounds.isEmpty()) {
+        bounds = Aabb(QVector3D(position.x(), 0.0f, position.y()), QVector3D(position.x() + 1, 1.0f, position.y() + 1));
+        m_provisionalPickBounds.push_back(position);
+    }
+    m_picker.setPlantBounds(position, bounds);
+}
 
-    // Undo projection to go to view space
-    QVector4D rayEye = invProjection * rayClip;
-    rayEye.setZ(-1.0f); // Point ray forward
-    rayEye.setW(0.0f); // Convert to direction vector
-    // Undo view transformation to go to world
-    QVector4D rayWorld = invView * rayEye;
-    QVector3D rayDir(rayWorld.x(), rayWorld.y(), rayWorld.z());
-    rayDir.normalize();
+void GardenGLWidget::refreshProvisionalPickBounds() {
+    if (m_provisionalPickBounds.empty()) return;
 
-    // Intersection with ground plane (y=0)
-    QVector3D camPos = m_camera->getPosition();
-    float t = -camPos.y() / rayDir.y();
-    return camPos + rayDir * t; // Intersection point
+    const GardenModel* gardenModel = m_controller->getModel();
+    std::vector<QPoint> waiting;
+    waiting.swap(m_provisionalPickBounds);
+    for (const QPoint &position : waiting) {
+        Plant* plant = gardenModel->getPlant(position);
+        if (plant) updatePickBounds(position, plant);  // removed plants just drop out
+    }
 }
 
 void GardenGLWidget::dragEnterEvent(QDragEnterEvent* event) {
@@ -406,6 +248,7 @@ void GardenGLWidget::dragEnterEvent(QDragEnterEvent* event) {
 
         // Activate preview mode
         m_isPreviewActive = true;
+        m_repaint.markDirty(RepaintScheduler::Overlay);
 
         // Accept the drag operation
         event->acceptProposedAction();
@@ -413,8 +256,13 @@ void GardenGLWidget::dragEnterEvent(QDragEnterEvent* event) {
 }
 
 void GardenGLWidget::dragMoveEvent(QDragMoveEvent* event) {
-    // Get world position
-    QVector3D worldPos = screenToWorld(event->pos());
+    // Get world position, above the horizon there's nothing to snap to
+    GridPicker::Hit hit = pickAt(event->pos());
+    if (!hit.hitsGround) {
+        event->acceptProposedAction();
+        return;
+    }
+    QVector3D worldPos = hit.ground;
 
     // Calculate the grid cell position (for snapping)
     float gridX = std::floor(worldPos.x());
@@ -427,22 +275,27 @@ void GardenGLWidget::dragMoveEvent(QDragMoveEvent* event) {
     // Update preview position with snapping
     if (m_isPreviewActive) {
         // Snap to grid cell centers
-        m_previewPosition = QVector3D(
+        QVector3D snapped(
                 gridX + 0.5f,  // Snap X to cell center
                 0.0f,         // Ground level
                 gridZ + 0.5f  // Snap Z to cell center
         );
+
+        // Moving inside the same cell looks the same
+        if (snapped != m_previewPosition) {
+            m_previewPosition = snapped;
+            m_repaint.markDirty(RepaintScheduler::Overlay);
+        }
     }
 
     event->acceptProposedAction();
-    update();
 }
 
 void GardenGLWidget::dragLeaveEvent(QDragLeaveEvent* event) {
     // Deactivate preview when drag leaves the widget
     m_isPreviewActive = false;
     event->accept();
-    update();
+    m_repaint.markDirty(RepaintScheduler::Overlay);
 }
 
 void GardenGLWidget::dropEvent(QDropEvent* event) {
@@ -458,95 +311,18 @@ void GardenGLWidget::dropEvent(QDropEvent* event) {
     // Clean up preview state
     m_isPreviewActive = false;
     event->acceptProposedAction();
-    update();
+    m_repaint.markDirty(RepaintScheduler::Overlay);
 }
 
 
 QPoint GardenGLWidget::screenToGrid(const QPoint& screenPos) {
-    QVector3D worldPos = screenToWorld(screenPos);
-
-    // Floor the world coordinates to make sure within bounds
-    int x = static_cast<int>(std::floor(worldPos.x()));
-    int z = static_cast<int>(std::floor(worldPos.z()));
-
-    x = std::clamp(x, 0, GRID_SIZE - 1);
-    z = std::clamp(z, 0, GRID_SIZE - 1);
-
-    return QPoint(x, z);
-}
-
-bool GardenGLWidget::canPlacePlant(const QPoint& gridPos) const {
-    if (gridPos.x() < 0 || gridPos.x() >= GRID_SIZE ||
-        gridPos.y() < 0 || gridPos.y() >= GRID_SIZE) {
-        return false;
-    }
-
-    // Extra safety check for the preview position
-    if (m_previewPosition.x() >= GRID_SIZE ||
-        m_previewPosition.z() >= GRID_SIZE) {
-        return false;
-    }
-
-    const GridCell& cell = m_grid[gridPos.x()][gridPos.y()];
-    return cell.hasBed && !cell.plant;
-}
-
-
-
-bool GardenGLWidget::addPlant(Plant::Type type, const QPoint& gridPos) {
-    if (!canPlacePlant(gridPos)) {
-        return false;
-    }
-
-    QString basePath = "/Users/raphaelrusso/CLionProjects/garden_simulation/models/plants/";
-    QString modelName;
-    QString plantName;
-
-    switch (type) {
-        case Plant::Type::Carrot:
-            modelName = "carrot.obj";
-            plantName = "Carrot";
-            break;
-        case Plant::Type::Pumpkin:
-            modelName = "pumpkin.obj";
-            plantName = "Pumpkin";
-            break;
-        case Plant::Type::Tomato:
-            modelName = "tomato.obj";
-            plantName = "Tomato";
-            break;
-    }
-
-    auto newPlant = std::make_shared<Plant>(
-            type,
-            basePath + modelName,
-            plantName,
-            ""
-    );
-
-    QVector3D position(gridPos.x() + 0.5f, 0.0f, gridPos.y() + 0.5f);
-    m_grid[gridPos.x()][gridPos.y()].plant = newPlant;
-    m_grid[gridPos.x()][gridPos.y()].position = position;
-
-    newPlant->getModel()->setPosition(position);
-    newPlant->setGridPosition(gridPos);
-
-    qDebug() << "Added plant:" << plantName << "at position:" << position;
-
-    update();
-    return true;
-}
-
-void GardenGLWidget::removePlant(const QPoint& gridPos) {
-    if (gridPos.x() >= 0 && gridPos.x() < GRID_SIZE &&
-        gridPos.y() >= 0 && gridPos.y() < GRID_SIZE) {
-        m_grid[gridPos.x()][gridPos.y()].plant.reset();
-        update();
-    }
+    // Off the garden is no cell, not the nearest edge one
+    return pickAt(screenPos).cell;
 }
 
 void GardenGLWidget::updatePreviewModel(Plant::Type type) {
-    QString basePath = "/Users/raphaelrusso/CLionProjects/garden_simulation/models/plants/";
+    // Same files the placed plants load, so the preview shares their cached mesh
+    QString basePath = m_controller->getModel()->getModelDirectory() + "/";
     QString modelName;
 
     switch (type) {
@@ -572,132 +348,103 @@ void GardenGLWidget::updatePreviewModel(Plant::Type type) {
 }
 
 
-QVector3D GardenGLWidget::calculateSunColor(float temperature) {
-    // Normalize temperature to 0-1 range (30F to 90F)
-    float t = (temperature - 30.0f) / 60.0f;
-    t = std::max(0.0f, std::min(1.0f, t));  // Clamp to 0-1
-
-    // Define color ranges for different temperatures
-    QVector3D coldColor(0.6f, 0.7f, 1.0f);    // Cool blueish
-    QVector3D midColor(1.0f, 0.95f, 0.8f);    // Neutral warm
-    QVector3D hotColor(1.0f, 0.6f, 0.4f);     // Warm orangey red
-
-    // Interpolate between colors
-    if (t < 0.5f) {
-        return interpolateColors(coldColor, midColor, t * 2.0f);
-    } else {
-        return interpolateColors(midColor, hotColor, (t - 0.5f) * 2.0f);
+// Model update handlers
+void GardenGLWidget::onPlantAdded(const QPoint& position, Plant::Type type) {
+    Plant* plant = m_controller->getModel()->getPlant(position);
+    if (plant) {
+        // Placed once here, the highlight reuses the model's transform
+        plant->getModel()->setPosition(QVector3D(position.x() + 0.5f, 0.0f, position.y() + 0.5f));
+        if (m_scene) {
+            // Replacing a plant of another kind can empty a tile, which deletes its buffers
+            makeCurrent();
+            m_scene->addPlant(position, type, plant->getModel()->getSharedMesh());
+            doneCurrent();
+        }
+        updatePickBounds(position, plant);
     }
+    m_repaint.markDirty(RepaintScheduler::Plants);
 }
 
-QVector3D GardenGLWidget::interpolateColors(const QVector3D& color1, const QVector3D& color2, float t) {
-    // Clamp t to [0,1] range
-    t = std::max(0.0f, std::min(1.0f, t));
-
-    // Linearly interpolate each component
-    return QVector3D(
-            color1.x() + (color2.x() - color1.x()) * t,
-            color1.y() + (color2.y() - color1.y()) * t,
-            color1.z() + (color2.z() - color1.z()) * t
-    );
-}
-
-void GardenGLWidget::drawCube(GLuint& vao, GLuint& vbo) {
-    // Define vertices for a complete cube
-    static const float vertices[] = {
-            // Front face         // Normal
-            -0.5f, -0.5f, -0.5f, 0.0f, 0.0f, -1.0f,  // Bottom left
-            0.5f, -0.5f, -0.5f,  0.0f, 0.0f, -1.0f,  // Bottom right
-            0.5f, 0.5f, -0.5f,   0.0f, 0.0f, -1.0f,  // Top right
-            -0.5f, -0.5f, -0.5f, 0.0f, 0.0f, -1.0f,  // Bottom left
-            0.5f, 0.5f, -0.5f,   0.0f, 0.0f, -1.0f,  // Top right
-            -0.5f, 0.5f, -0.5f,  0.0f, 0.0f, -1.0f,  // Top left
-
-            // Back face
-            -0.5f, -0.5f, 0.5f,  0.0f, 0.0f, 1.0f,
-            0.5f, -0.5f, 0.5f,   0.0f, 0.0f, 1.0f,
-            0.5f, 0.5f, 0.5f,    0.0f, 0.0f, 1.0f,
-            -0.5f, -0.5f, 0.5f,  0.0f, 0.0f, 1.0f,
-            0.5f, 0.5f, 0.5f,    0.0f, 0.0f, 1.0f,
-            -0.5f, 0.5f, 0.5f,   0.0f, 0.0f, 1.0f,
-
-            // Left face
-            -0.5f, -0.5f, 0.5f,  -1.0f, 0.0f, 0.0f,
-            -0.5f, -0.5f, -0.5f, -1.0f, 0.0f, 0.0f,
-            -0.5f, 0.5f, -0.5f,  -1.0f, 0.0f, 0.0f,
-            -0.5f, -0.5f, 0.5f,  -1.0f, 0.0f, 0.0f,
-            -0.5f, 0.5f, -0.5f,  -1.0f, 0.0f, 0.0f,
-            -0.5f, 0.5f, 0.5f,   -1.0f, 0.0f, 0.0f,
-
-            // Right face
-            0.5f, -0.5f, 0.5f,   1.0f, 0.0f, 0.0f,
-            0.5f, -0.5f, -0.5f,  1.0f, 0.0f, 0.0f,
-            0.5f, 0.5f, -0.5f,   1.0f, 0.0f, 0.0f,
-            0.5f, -0.5f, 0.5f,   1.0f, 0.0f, 0.0f,
-            0.5f, 0.5f, -0.5f,   1.0f, 0.0f, 0.0f,
-            0.5f, 0.5f, 0.5f,    1.0f, 0.0f, 0.0f,
-
-            // Top face
-            -0.5f, 0.5f, -0.5f,  0.0f, 1.0f, 0.0f,
-            0.5f, 0.5f, -0.5f,   0.0f, 1.0f, 0.0f,
-            0.5f, 0.5f, 0.5f,    0.0f, 1.0f, 0.0f,
-            -0.5f, 0.5f, -0.5f,  0.0f, 1.0f, 0.0f,
-            0.5f, 0.5f, 0.5f,    0.0f, 1.0f, 0.0f,
-            -0.5f, 0.5f, 0.5f,   0.0f, 1.0f, 0.0f,
-
-            // Bottom face
-            -0.5f, -0.5f, -0.5f, 0.0f, -1.0f, 0.0f,
-            0.5f, -0.5f, -0.5f,  0.0f, -1.0f, 0.0f,
-            0.5f, -0.5f, 0.5f,   0.0f, -1.0f, 0.0f,
-            -0.5f, -0.5f, -0.5f, 0.0f, -1.0f, 0.0f,
-            0.5f, -0.5f, 0.5f,   0.0f, -1.0f, 0.0f,
-            -0.5f, -0.5f, 0.5f,  0.0f, -1.0f, 0.0f
-    };
-
-    // Bind and update buffer data
-    glBindVertexArray(vao);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    // Position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-
-    // Normal attribute
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float),
-                          (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    // Draw the cube
-    glDrawArrays(GL_TRIANGLES, 0, 36);
-}
+void GardenGLWidget::onPlantRemoved(const QPoint& position) {
+    if (m_scene) {
+        // The tile's instance buffers go if this was its last plant
+        makeCurrent();
+        m_scene->removePlant(position);
+        doneCurrent();
+    }
+    m_picker.removePlant(position);
 
+    // Whatever stood behind the removed plant is under the cursor now
+    if (m_deleteModeActive && m_hoverCameraVersion != 0) {
+        m_hoverCameraVersion = 0;
+        updateHover(m_hoverPos);
+    }
+    m_repaint.markDirty(RepaintScheduler::Plants);
+}
 
+void GardenGLWidget::onGardenLoaded() {
+    // Loading replaces the grid without removal signals, so start over from the model
+    if (m_scene) {
+        makeCurrent();
+        m_scene->clearPlants();
+        doneCurrent();
+    }
+    const GardenModel* gardenModel = m_controller->getModel();
+    m_picker.setGridSize(gardenModel->getGridSize());
+    m_provisionalPickBounds.clear();
+    for (int x = 0; x < gardenModel->getGridSize(); ++x) {
+        for (int z = 0; z < gardenModel->getGridSize(); ++z) {
+            Plant* plant = gardenModel->getPlant(QPoint(x, z));
+            if (plant) {
+                onPlantAdded(QPoint(x, z), plant->getType());
+            }
+        }
+    }
+    if (m_scene) m_scene->setLights(gardenModel->getLights());
 
-// Model update handlers
-void GardenGLWidget::onPlantAdded(const QPoint& position, Plant::Type type) {
-    update();
+    // The garden size can change too, the beds and grid lines check it every frame
+    m_repaint.markDirty(RepaintScheduler::Plants | RepaintScheduler::Beds | RepaintScheduler::Lighting);
 }
 
-void GardenGLWidget::onPlantRemoved(const QPoint& position) {
-    update();
+void GardenGLWidget::onLightsChanged() {
+    if (m_scene) m_scene->setLights(m_controller->getModel()->getLights());
+    m_repaint.markDirty(RepaintScheduler::Lighting);
 }
 
 void GardenGLWidget::onTemperatureChanged(float temperature) {
     m_temperature = temperature;
-    update();
+
+    // Sensor ticks mostly move the sun colour by less than the display can show
+    QVector4D lighting = SceneRenderer::sunLighting(temperature);
+    bool visible = false;
+    for (int i = 0; i < 4; ++i) {
+        visible = visible || isVisibleChange(m_requestedLighting[i], lighting[i]);
+    }
+    if (visible) {
+        m_requestedLighting = lighting;
+        if (m_scene) m_scene->setTemperature(temperature);
+        m_repaint.markDirty(RepaintScheduler::Lighting);
+    }
 }
 
 void GardenGLWidget::onMoistureChanged(float moisture) {
     m_moisture = moisture;
-    update();
+
+    // Same for the bed shade, see SceneRenderer::bedTint
+    float shade = 1.0f - 0.4f * std::clamp(moisture, 0.0f, 1.0f);
+    if (isVisibleChange(m_requestedBedShade, shade)) {
+        m_requestedBedShade = shade;
+        if (m_scene) m_scene->setMoisture(moisture);
+        m_repaint.markDirty(RepaintScheduler::Beds);
+    }
 }
 
 void GardenGLWidget::setDeleteMode(bool enabled) {
     m_deleteModeActive = enabled;
+    m_hoverCameraVersion = 0;  // picked fresh on the next move
     // Change cursor to indicate delete mode
     setCursor(enabled ? Qt::CrossCursor : Qt::ArrowCursor);
-    update();
+    m_repaint.markDirty(RepaintScheduler::Overlay);
 }
 
 void GardenGLWidget::handleDeleteModeClick(const QPoint& gridPos) {
@@ -707,48 +454,39 @@ void GardenGLWidget::handleDeleteModeClick(const QPoint& gridPos) {
     }
 }
 
-void GardenGLWidget::renderPlantHighlight(const QPoint& position, const QVector3D& color) {
+void GardenGLWidget::queuePlantHighlight(RenderQueue& queue, const QPoint& position, const QVector3D& color) {
     Plant* plant = m_controller->getModel()->getPlant(position);
     if (!plant) return;
 
-    // Save OpenGL state
-    GLint previousDepthFunc;
-    glGetIntegerv(GL_DEPTH_FUNC, &previousDepthFunc);
-
-    // Set up highlight rendering
-    m_modelShader->bind();
-    m_modelShader->setBool("isPreview", true);
-    m_modelShader->setVec3("previewColor", color);
-    m_modelShader->setFloat("previewAlpha", 0.6f);
-
     // Get the original model's transform and modify it for the highlight
     QMatrix4x4 transform = plant->getModel()->getModelMatrix();
     transform.scale(1.05f);  // Scale up from the original transform
-    m_modelShader->setMat4("model", transform);
-
-    // Draw using the model's own draw method
-    plant->getModel()->draw(m_modelShader.get());
 
-    // Restore previous state
-    glDepthFunc(previousDepthFunc);
-    m_modelShader->setBool("isPreview", false);
+    DrawPacket highlight;
+    highlight.pass = RenderPass::Overlay;
+    highlight.shader = m_scene->modelShader();
+    highlight.mesh = plant->getModel()->getMesh();
+    highlight.model = transform;
+    highlight.overlayColor = QVector4D(color, 0.6f);
+    highlight.depth = m_camera->getPosition().distanceToPoint(transform.column(3).toVector3D());
+    highlight.section = FrameProfiler::Highlight;
+    queue.submit(highlight);
 }
 
 void GardenGLWidget::enterEvent(QEnterEvent* event) {
     // Mouse entered the widget
     if (m_deleteModeActive) {
         // Start tracking mouse position
-        QPoint pos = mapFromGlobal(QCursor::pos());
-        m_hoveredCell = screenToGrid(pos);
-        update();
+        updateHover(mapFromGlobal(QCursor::pos()));
     }
 }
 
 void GardenGLWidget::leaveEvent(QEvent* event) {
     // Mouse left the widget
     if (m_deleteModeActive) {
-        // Clear hover state
+        // Clear hover state, coming back in picks again
         m_hoveredCell = QPoint(-1, -1);
-        update();
+        m_hoverCameraVersion = 0;
+        m_repaint.markDirty(RepaintScheduler::Overlay);
     }
 }
\ No newline at end of file
@@ -10,28 +10,49 @@
 #include <QOpenGLFunctions_3_3_Core>
 #include "../renderer/shader.h"
 #include "../renderer/camera.h"
+#include "../renderer/glstatecache.h"
+#include "../renderer/gputimer.h"
+#include "../renderer/gridpicker.h"
+#include "../renderer/scenerenderer.h"
 #include "../model/model.h"
 #include "src/model/plant.h"
 #include "controller/gardencontroller.h"
+#include "view/repaintscheduler.h"
+#include <cmath>
 #include <memory>
 
-struct GridCell {
-    bool hasBed;
-    QVector3D position;
-    float moisture;  // Will be used later for soil moisture visualization
-    std::shared_ptr<Plant> plant;
-};
-
 class GardenGLWidget : public QOpenGLWidget, protected QOpenGLFunctions_3_3_Core {
 Q_OBJECT
 
 public:
     explicit GardenGLWidget(GardenController* controller, QWidget* parent = nullptr);
-    ~GardenGLWidget() override = default;
+    ~GardenGLWidget() override;
+
+    // Uniform calls issued/skipped during the last paintGL
+    Shader::UniformStats lastUniformStats() const { return m_scene ? m_scene->lastUniformStats() : Shader::UniformStats(); }
+
+    // Binds issued/dropped by the state cache during the last paintGL
+    GLStateCache::Stats lastStateStats() const { return m_scene ? m_scene->lastStateStats() : GLStateCache::Stats(); }
+
+    // Beds and plants kept or thrown away by frustum culling in the last paintGL
+    CullStats lastCullStats() const { return m_scene ? m_scene->lastCullStats() : CullStats(); }
+
+    // Point light assignment and per frame streamed uploads of the last paintGL
+    LightClusters::Stats lastLightStats() const { return m_scene ? m_scene->lastLightStats() : LightClusters::Stats(); }
+    StreamBuffer::Stats lastStreamStats() const { return m_scene ? m_scene->lastStreamStats() : StreamBuffer::Stats(); }
+
+    // Frames painted and GPU time since the last call, see StatsPanel
+    struct RenderActivity {
+        RepaintScheduler::Stats frames;
+        qint64 gpuNs = 0;
+    };
+    RenderActivity takeActivity();
+
+    // Per pass timings for ProfilerPanel, only frames painted while it's on are recorded
+    void setProfiling(bool enabled);
+    FrameProfiler::Summary profileSummary() const;
+    bool exportProfile(const QString& path) const;
 
-    bool canPlacePlant(const QPoint& gridPos) const;
-    bool addPlant(Plant::Type type, const QPoint& gridPos);
-    void removePlant(const QPoint& gridPos);
     void setDeleteMode(bool enabled);
 
 signals:
@@ -42,6 +63,8 @@ private slots:
     void onPlantRemoved(const QPoint& position);
     void onTemperatureChanged(float temperature);
     void onMoistureChanged(float moisture);
+    void onLightsChanged();
+    void onGardenLoaded();
 
 protected:
     void initializeGL() override;
@@ -60,45 +83,41 @@ protected:
     void leaveEvent(QEvent* event) override;
 
 private:
-    static const int GRID_SIZE = 10;
+    static constexpr qint64 UPLOAD_BUDGET_NS = 4000000;  // 4ms of each frame for asset uploads
 
     GardenController* m_controller;
 
-    // OpenGL objects
-    std::unique_ptr<Shader> m_gridShader;
-    std::unique_ptr<Shader> m_modelShader;
-    std::unique_ptr<Model> m_bedModel;
     std::unique_ptr<Camera> m_camera;
-    std::unique_ptr<Shader> m_sunShader;
 
-    // Grid rendering
-    GLuint m_gridVAO, m_gridVBO;
-    std::vector<std::vector<GridCell>> m_grid;
+    // Grid, beds, plants and sun, created with the context in initializeGL
+    // Plants are kept up to date from the plantAdded/plantRemoved signals
+    std::unique_ptr<SceneRenderer> m_scene;
+
+    // Repaints only for visible changes, one frame per refresh at most
+    RepaintScheduler m_repaint{this};
+    GpuTimer m_gpuTimer;
 
-    // Sun rendering
-    GLuint m_sunVAO, m_sunVBO;
-    QVector3D m_sunPosition;
-    void initializeSun();
-    QVector3D calculateSunColor(float temperature);
-    QVector3D interpolateColors(const QVector3D& color1, const QVector3D& color2, float t);
-    void renderSun(const QMatrix4x4 &view, const QMatrix4x4 &projection);
-    void drawCube(GLuint &vao, GLuint &vbo);
+    // Lighting and bed shade as of the last repaint request, sensor noise below a display step is dropped
+    QVector4D m_requestedLighting;  // sun colour and intensity
+    float m_requestedBedShade = -1.0f;
+    static bool isVisibleChange(float from, float to) { return std::abs(to - from) >= 0.5f / 255.0f; }
 
     // Environmental parameters
     float m_temperature;  // Will control light color
     float m_moisture;     // Will control bed darkness
+    bool m_profiling = false;
 
     // Mouse tracking
     QPoint m_lastPos;
 
-    // Initialize helpers
-    void initializeShaders();
-    void initializeGridLines();
-    void initializeModels();
-    void initializeGridCells();
+    // Beds and plant boxes under the cursor, kept up to date from the same signals as the scene
+    GridPicker m_picker;
+    std::vector<QPoint> m_provisionalPickBounds;  // plants whose mesh didn't know its bounds yet
+    GridPicker::Hit pickAt(const QPoint& screenPos) const;
+    void updatePickBounds(const QPoint& position, const Plant* plant);
+    void refreshProvisionalPickBounds();
 
     // Utility functions
-    QVector3D screenToWorld(const QPoint& screenPos);
     void handleGridClick(const QPoint& gridPos);
 
     bool m_isPreviewActive = false;
@@ -111,13 +130,18 @@ private:
 
 
 
+    // Bed under the cursor, (-1, -1) off the garden
     QPoint screenToGrid(const QPoint& screenPos);
 
 
     // Deletion
     bool m_deleteModeActive = false;
     QPoint m_hoveredCell = QPoint(-1, -1);
-    void renderPlantHighlight(const QPoint& position, const QVector3D& color);
+    QPoint m_hoverPos;
+    quint64 m_hoverCameraVersion = 0;  // camera the hover was picked with, 0 to pick again
+    void updateHover(const QPoint& screenPos);
+    void queueOverlays(RenderQueue& queue, const Frustum& frustum);
+    void queuePlantHighlight(RenderQueue& queue, const QPoint& position, const QVector3D& color);
     void handleDeleteModeClick(const QPoint& gridPos);
 
 
@@ -4,6 +4,8 @@
 
 #include "mainwindow.h"
 #include "plantdragbutton.h"
+#include "profilerpanel.h"
+#include "statspanel.h"
 #include <QMenuBar>
 #include <QToolBar>
 #include <QStatusBar>
@@ -66,6 +68,12 @@ void MainWindow::createMenus() {
     if (m_environmentDock) {
         viewMenu->addAction(m_environmentDock->toggleViewAction());
     }
+    if (m_statsDock) {
+        viewMenu->addAction(m_statsDock->toggleViewAction());
+    }
+    if (m_profilerDock) {
+        viewMenu->addAction(m_profilerDock->toggleViewAction());
+    }
 
     // Help menu
     QMenu* helpMenu = menuBar()->addMenu(tr("&Help"));
@@ -144,6 +152,20 @@ void MainWindow::createDockWindows() {
 
     m_environmentDock->setWidget(envWidget);
     addDockWidget(Qt::RightDockWidgetArea, m_environmentDock);
+
+    // Render stats, hidden until asked for from the View menu
+    m_statsDock = new QDockWidget(tr("Performance"), this);
+    m_statsDock->setAllowedAreas(Qt::LeftDockWidgetArea | Qt::RightDockWidgetArea);
+    m_statsDock->setWidget(new StatsPanel(m_gardenWidget, m_statsDock));
+    addDockWidget(Qt::RightDockWidgetArea, m_statsDock);
+    m_statsDock->hide();
+
+    // Per pass timings, profiling only runs while this is open
+    m_profilerDock = new QDockWidget(tr("Profiler"), this);
+    m_profilerDock->setAllowedAreas(Qt::LeftDockWidgetArea | Qt::RightDockWidgetArea | Qt::BottomDockWidgetArea);
+    m_profilerDock->setWidget(new ProfilerPanel(m_gardenWidget, m_profilerDock));
+    addDockWidget(Qt::BottomDockWidgetArea, m_profilerDock);
+    m_profilerDock->hide();
 }
 
 void MainWindow::createToolbar() {
@@ -44,6 +44,8 @@ private:
 
     QDockWidget *m_toolsDock;
     QDockWidget *m_environmentDock;
+    QDockWidget *m_statsDock;
+    QDockWidget *m_profilerDock;
     QLabel *m_tempLabel;
     QSlider *m_tempSlider;
     QLabel *m_moistureLabel;
@@ -0,0 +1,85 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include <QFileDialog>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QVBoxLayout>
+#include "profilerpanel.h"
+#include "gardenglwidget.h"
+
+ProfilerPanel::ProfilerPanel(GardenGLWidget *view, QWidget *parent)
+        : QWidget(parent)
+        , m_view(view)
+        , m_table(new QTableWidget(FrameProfiler::SectionCount, 6, this))
+        , m_framesLabel(new QLabel(this))
+        , m_exportButton(new QPushButton(tr("Export CSV..."), this))
+{
+    m_table->setHorizontalHeaderLabels({tr("CPU p50"), tr("CPU p95"), tr("CPU p99"),
+                                        tr("GPU p50"), tr("GPU p95"), tr("GPU p99")});
+    for (int section = 0; section < FrameProfiler::SectionCount; ++section) {
+        m_table->setVerticalHeaderItem(section, new QTableWidgetItem(
+                FrameProfiler::sectionName(FrameProfiler::Section(section))));
+        for (int column = 0; column < 6; ++column) {
+            QTableWidgetItem *item = new QTableWidgetItem();
+            item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            m_table->setItem(section, column, item);
+        }
+    }
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addWidget(m_framesLabel);
+    layout->addWidget(m_table);
+    layout->addWidget(m_exportButton);
+
+    connect(m_exportButton, &QPushButton::clicked, this, &ProfilerPanel::exportCsv);
+
+    m_refreshTimer.setInterval(500);
+    m_refreshTimer.setTimerType(Qt::CoarseTimer);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &ProfilerPanel::refresh);
+}
+
+void ProfilerPanel::showEvent(QShowEvent *event) {
+    QWidget::showEvent(event);
+    m_view->setProfiling(true);
+    m_refreshTimer.start();
+    refresh();
+}
+
+void ProfilerPanel::hideEvent(QHideEvent *event) {
+    m_refreshTimer.stop();
+    m_view->setProfiling(false);
+    QWidget::hideEvent(event);
+}
+
+void ProfilerPanel::refresh() {
+    FrameProfiler::Summary summary = m_view->profileSummary();
+
+    // The view only paints when something changes, so a still garden records nothing new
+    m_framesLabel->setText(tr("Frames: %1 (%2 dropped), ms").arg(summary.frames).arg(summary.droppedFrames));
+
+    for (int section = 0; section < FrameProfiler::SectionCount; ++section) {
+        const FrameProfiler::Percentiles *sides[2] = {&summary.cpu[size_t(section)], &summary.gpu[size_t(section)]};
+        for (int side = 0; side < 2; ++side) {
+            const FrameProfiler::Percentiles &p = *sides[side];
+            double values[3] = {p.p50, p.p95, p.p99};
+            for (int i = 0; i < 3; ++i) {
+                m_table->item(section, side * 3 + i)->setText(
+                        p.samples > 0 ? QString::number(values[i], 'f', 3) : QString("-"));
+            }
+        }
+    }
+}
+
+void ProfilerPanel::exportCsv() {
+    QString path = QFileDialog::getSaveFileName(this, tr("Export Profile"), "profile.csv",
+                                                tr("CSV Files (*.csv)"));
+    if (path.isEmpty()) return;
+
+    if (!m_view->exportProfile(path)) {
+        QMessageBox::warning(this, tr("Export Profile"), tr("Could not write %1").arg(path));
+    }
+}
@@ -0,0 +1,42 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_PROFILERPANEL_H
+#define GARDEN_SIMULATION_PROFILERPANEL_H
+
+#pragma once
+#include <QLabel>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QTimer>
+#include <QWidget>
+
+class GardenGLWidget;
+
+// CPU and GPU p50/p95/p99 per render pass over the view's recent frames, with CSV export
+// Profiling is only on while the panel is shown, the view doesn't pay for the queries otherwise
+class ProfilerPanel : public QWidget {
+Q_OBJECT
+
+public:
+    explicit ProfilerPanel(GardenGLWidget *view, QWidget *parent = nullptr);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    GardenGLWidget *m_view;
+    QTimer m_refreshTimer;
+
+    QTableWidget *m_table;
+    QLabel *m_framesLabel;
+    QPushButton *m_exportButton;
+
+    void refresh();
+    void exportCsv();
+};
+
+
+#endif //GARDEN_SIMULATION_PROFILERPANEL_H
@@ -0,0 +1,72 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include <QStringList>
+#include <algorithm>
+#include <utility>
+#include "repaintscheduler.h"
+
+RepaintScheduler::RepaintScheduler(QWidget *target) : m_target(target) {
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, m_target, [this]() { m_target->update(); });
+}
+
+void RepaintScheduler::markDirty(quint32 reasons) {
+    if (reasons == 0) return;
+    ++m_stats.requests;
+    m_pending |= reasons;
+
+    // Already a frame on the way, it'll pick these up
+    if (m_scheduled) {
+        ++m_stats.coalesced;
+        return;
+    }
+    m_scheduled = true;
+
+    // Right away if the last frame is a refresh old, otherwise wait out the rest of it
+    qint64 elapsed = m_sinceFrame.isValid() ? m_sinceFrame.nsecsElapsed() : m_intervalNs;
+    qint64 remaining = m_intervalNs - elapsed;
+    if (remaining <= 0) {
+        m_target->update();
+    } else {
+        m_timer.start(int((remaining + 999999) / 1000000));
+    }
+}
+
+quint32 RepaintScheduler::beginFrame() {
+    m_timer.stop();
+    m_scheduled = false;
+    m_sinceFrame.start();
+
+    quint32 reasons = m_pending;
+    m_pending = 0;
+    ++m_stats.framesPainted;
+    m_stats.lastReasons = reasons;
+    return reasons;
+}
+
+void RepaintScheduler::setFrameInterval(qint64 nanoseconds) {
+    m_intervalNs = std::max<qint64>(nanoseconds, 1000000);
+}
+
+RepaintScheduler::Stats RepaintScheduler::takeStats() {
+    Stats stats = m_stats;
+    m_stats = Stats();
+    m_stats.lastReasons = stats.lastReasons;
+    return stats;
+}
+
+QString RepaintScheduler::describe(quint32 reasons) {
+    static const std::pair<Reason, const char*> names[] = {
+            {Camera, "camera"}, {Lighting, "lighting"}, {Plants, "plants"},
+            {Beds, "beds"}, {Overlay, "overlay"}, {Assets, "assets"}
+    };
+
+    QStringList parts;
+    for (const auto &[reason, name] : names) {
+        if (reasons & reason) parts << QString::fromLatin1(name);
+    }
+    return parts.isEmpty() ? QStringLiteral("expose") : parts.join(", ");
+}
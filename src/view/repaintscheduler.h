@@ -0,0 +1,67 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_REPAINTSCHEDULER_H
+#define GARDEN_SIMULATION_REPAINTSCHEDULER_H
+
+#pragma once
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QWidget>
+
+// Decides when the garden view repaints. Nothing draws unless something visible changed,
+// and a burst of changes (mouse moves, sensor ticks, staged assets) waits for the next
+// refresh interval and goes out as one frame. Between changes the app sits in the event loop
+class RepaintScheduler : public QObject {
+Q_OBJECT
+
+public:
+    // What changed since the last frame, OR'd together
+    enum Reason : quint32 {
+        Camera   = 1u << 0,  // orbit, pan, zoom, resize
+        Lighting = 1u << 1,  // sun colour from temperature
+        Plants   = 1u << 2,
+        Beds     = 1u << 3,  // moisture tint, garden size
+        Overlay  = 1u << 4,  // drag preview, delete hover
+        Assets   = 1u << 5   // uploads that finished or are still queued
+    };
+
+    struct Stats {
+        int framesPainted = 0;
+        int requests = 0;    // markDirty calls
+        int coalesced = 0;   // of those, folded into a frame that was already coming
+        quint32 lastReasons = 0;
+    };
+
+    // Lives inside target (a member), so no parent
+    explicit RepaintScheduler(QWidget *target);
+
+    void markDirty(quint32 reasons);
+
+    // Top of paintGL, returns what changed. Empty when Qt repaints on its own (expose, resize)
+    quint32 beginFrame();
+
+    // One refresh of the screen the widget is on, frames never go out faster than this
+    void setFrameInterval(qint64 nanoseconds);
+    qint64 frameInterval() const { return m_intervalNs; }
+
+    // Counts since the last call, for the stats panel
+    Stats takeStats();
+
+    static QString describe(quint32 reasons);
+
+private:
+    QWidget *m_target;
+    QTimer m_timer;
+    QElapsedTimer m_sinceFrame;
+    qint64 m_intervalNs = 16666667;  // 60Hz until the screen says otherwise
+    quint32 m_pending = 0;
+    bool m_scheduled = false;
+    Stats m_stats;
+};
+
+
+#endif //GARDEN_SIMULATION_REPAINTSCHEDULER_H
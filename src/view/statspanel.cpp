@@ -0,0 +1,97 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#include <QVBoxLayout>
+#include "statspanel.h"
+#include "gardenglwidget.h"
+
+StatsPanel::StatsPanel(GardenGLWidget *view, QWidget *parent)
+        : QWidget(parent)
+        , m_view(view)
+        , m_framesLabel(new QLabel(this))
+        , m_reasonLabel(new QLabel(this))
+        , m_cpuLabel(new QLabel(this))
+        , m_gpuLabel(new QLabel(this))
+        , m_uniformLabel(new QLabel(this))
+        , m_bindLabel(new QLabel(this))
+        , m_cullLabel(new QLabel(this))
+        , m_lightLabel(new QLabel(this))
+        , m_streamLabel(new QLabel(this))
+{
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addWidget(m_framesLabel);
+    layout->addWidget(m_reasonLabel);
+    layout->addWidget(m_cpuLabel);
+    layout->addWidget(m_gpuLabel);
+    layout->addWidget(m_uniformLabel);
+    layout->addWidget(m_bindLabel);
+    layout->addWidget(m_cullLabel);
+    layout->addWidget(m_lightLabel);
+    layout->addWidget(m_streamLabel);
+    layout->addStretch();
+
+    // Coarse on purpose, the panel shouldn't be what keeps the CPU busy
+    m_pollTimer.setInterval(1000);
+    m_pollTimer.setTimerType(Qt::CoarseTimer);
+    connect(&m_pollTimer, &QTimer::timeout, this, &StatsPanel::poll);
+}
+
+void StatsPanel::showEvent(QShowEvent *event) {
+    QWidget::showEvent(event);
+
+    // Start a fresh window, whatever happened while hidden isn't counted
+    m_view->takeActivity();
+    m_lastCpu = std::clock();
+    m_wallClock.start();
+    m_pollTimer.start();
+    m_framesLabel->setText(tr("Frames: measuring..."));
+}
+
+void StatsPanel::hideEvent(QHideEvent *event) {
+    m_pollTimer.stop();
+    QWidget::hideEvent(event);
+}
+
+void StatsPanel::poll() {
+    double wallMs = m_wallClock.nsecsElapsed() / 1e6;
+    m_wallClock.start();
+    if (wallMs <= 0.0) return;
+
+    // Process CPU time over wall time, 100% is one core busy
+    std::clock_t cpu = std::clock();
+    double cpuMs = double(cpu - m_lastCpu) * 1000.0 / CLOCKS_PER_SEC;
+    m_lastCpu = cpu;
+
+    GardenGLWidget::RenderActivity activity = m_view->takeActivity();
+    double seconds = wallMs / 1000.0;
+    double gpuMs = activity.gpuNs / 1e6;
+
+    m_framesLabel->setText(tr("Frames: %1/s (%2 requests, %3 coalesced)")
+                                   .arg(activity.frames.framesPainted / seconds, 0, 'f', 1)
+                                   .arg(activity.frames.requests)
+                                   .arg(activity.frames.coalesced));
+    m_reasonLabel->setText(tr("Last repaint: %1").arg(RepaintScheduler::describe(activity.frames.lastReasons)));
+    m_cpuLabel->setText(tr("CPU: %1%").arg(100.0 * cpuMs / wallMs, 0, 'f', 1));
+    m_gpuLabel->setText(tr("GPU: %1% (%2 ms/frame)")
+                                .arg(100.0 * gpuMs / wallMs, 0, 'f', 1)
+                                .arg(activity.frames.framesPainted > 0 ? gpuMs / activity.frames.framesPainted : 0.0,
+                                     0, 'f', 2));
+
+    Shader::UniformStats uniforms = m_view->lastUniformStats();
+    m_uniformLabel->setText(tr("Uniforms: %1 set, %2 skipped").arg(uniforms.issued).arg(uniforms.skipped));
+    GLStateCache::Stats binds = m_view->lastStateStats();
+    m_bindLabel->setText(tr("GL binds: %1 issued, %2 skipped").arg(binds.issued).arg(binds.skipped));
+    CullStats cull = m_view->lastCullStats();
+    m_cullLabel->setText(tr("Culling: %1/%2 tiles, %3/%4 instances drawn, %5 nodes tested")
+                                 .arg(cull.tilesVisible).arg(cull.tilesVisible + cull.tilesCulled)
+                                 .arg(cull.instancesVisible).arg(cull.instancesVisible + cull.instancesCulled)
+                                 .arg(cull.nodesVisited));
+    LightClusters::Stats lights = m_view->lastLightStats();
+    m_lightLabel->setText(tr("Lights: %1/%2 visible, busiest cluster %3, %4 dropped, %5 us to assign")
+                                  .arg(lights.visibleLights).arg(lights.lights).arg(lights.busiestCluster)
+                                  .arg(lights.dropped).arg(lights.assignNs / 1000));
+    StreamBuffer::Stats stream = m_view->lastStreamStats();
+    m_streamLabel->setText(tr("Streamed: %1 bytes in %2 uploads, %3 waits, %4 overflows")
+                                   .arg(stream.bytes).arg(stream.uploads).arg(stream.waits).arg(stream.overflows));
+}
@@ -0,0 +1,52 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+
+#ifndef GARDEN_SIMULATION_STATSPANEL_H
+#define GARDEN_SIMULATION_STATSPANEL_H
+
+#pragma once
+#include <QElapsedTimer>
+#include <QLabel>
+#include <QTimer>
+#include <QWidget>
+#include <ctime>
+
+class GardenGLWidget;
+
+// Frames, repaint reasons and CPU/GPU load of the garden view, once a second, plus the
+// renderer's counters (uniforms, binds, culling, lights, streaming) from its last frame
+// Only polls while shown, so a hidden panel doesn't keep the app awake
+class StatsPanel : public QWidget {
+Q_OBJECT
+
+public:
+    explicit StatsPanel(GardenGLWidget *view, QWidget *parent = nullptr);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    GardenGLWidget *m_view;
+    QTimer m_pollTimer;
+    QElapsedTimer m_wallClock;
+    std::clock_t m_lastCpu = 0;
+
+    QLabel *m_framesLabel;
+    QLabel *m_reasonLabel;
+    QLabel *m_cpuLabel;
+    QLabel *m_gpuLabel;
+
+    // Counters of the last frame painted
+    QLabel *m_uniformLabel;
+    QLabel *m_bindLabel;
+    QLabel *m_cullLabel;
+    QLabel *m_lightLabel;
+    QLabel *m_streamLabel;
+
+    void poll();
+};
+
+
+#endif //GARDEN_SIMULATION_STATSPANEL_H
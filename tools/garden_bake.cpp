@@ -0,0 +1,188 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+// Offline asset baker: parses each OBJ given on the command line, optimizes it for the
+// vertex cache and writes the binary .gmesh next to it, which Mesh loads instead of
+// re-parsing the text file. Vertices are stored compact (CompactVertex) whenever the
+// quantization error stays within tolerance, --full keeps everything as floats.
+// The textures the models' materials use are block compressed into a .gtex next to each
+// image (BC1, or BC3 with alpha, for colour and BC5 for normal maps), --no-textures skips them.
+// Usage: garden_bake [--overdraw] [--full] [--no-textures] <model.obj> [more.obj ...]
+//
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QImage>
+#include <QMap>
+#include <cmath>
+#include <cstdio>
+#include "model/bakedmesh.h"
+#include "model/bakedtexture.h"
+#include "model/blockcompressor.h"
+#include "model/compactvertex.h"
+#include "model/meshoptimizer.h"
+#include "model/objparser.h"
+
+namespace {
+
+bool hasTransparency(const QImage &rgba) {
+    const uchar *pixels = rgba.constBits();
+    for (qsizetype i = 3; i < rgba.sizeInBytes(); i += 4) {
+        if (pixels[i] != 255) return true;
+    }
+    return false;
+}
+
+// Root mean square error of a compressed level against the RGBA it came from, over the
+// channels the format keeps
+double compressionError(TextureFormat format, const QImage &original, const MipLevel &level) {
+    int blocksX = (level.width + 3) / 4;
+    int blocksY = (level.height + 3) / 4;
+    size_t blockSize = format == TextureFormat::BC1 ? 8 : 16;
+    int channelCount = format == TextureFormat::BC5 ? 2 : (format == TextureFormat::BC3 ? 4 : 3);
+
+    double sum = 0.0;
+    size_t samples = 0;
+    uchar texels[16][4];
+    for (int by = 0; by < blocksY; ++by) {
+        for (int bx = 0; bx < blocksX; ++bx) {
+            const uchar *block = level.pixels + (size_t(by) * blocksX + bx) * blockSize;
+            switch (format) {
+                case TextureFormat::BC1:
+                    BlockCompressor::decodeBC1Block(block, texels);
+                    break;
+                case TextureFormat::BC3:
+                    BlockCompressor::decodeBC1Block(block + 8, texels);
+                    BlockCompressor::decodeBC4Block(block, 3, texels);
+                    break;
+                case TextureFormat::BC5:
+                    BlockCompressor::decodeBC4Block(block, 0, texels);
+                    BlockCompressor::decodeBC4Block(block + 8, 1, texels);
+                    break;
+                case TextureFormat::RGBA8:
+                    return 0.0;
+            }
+
+            for (int i = 0; i < 16; ++i) {
+                int x = bx * 4 + i % 4;
+                int y = by * 4 + i / 4;
+                if (x >= level.width || y >= level.height) continue;
+                const uchar *source = original.constScanLine(y) + x * 4;
+                for (int c = 0; c < channelCount; ++c) {
+                    double d = double(texels[i][c]) - double(source[c]);
+                    sum += d * d;
+                    ++samples;
+                }
+            }
+        }
+    }
+    return samples ? std::sqrt(sum / double(samples)) : 0.0;
+}
+
+bool bakeTexture(const QString &path, bool isNormalMap) {
+    QElapsedTimer timer;
+    timer.start();
+
+    QImage source(path);
+    if (source.isNull()) {
+        std::fprintf(stderr, "%s: can't read image, skipped\n", qPrintable(path));
+        return false;
+    }
+
+    QImage level0 = BakedTexture::prepareLevel0(source);
+    TextureFormat format = isNormalMap ? TextureFormat::BC5
+                                       : (hasTransparency(level0) ? TextureFormat::BC3 : TextureFormat::BC1);
+    std::vector<QImage> levels = BakedTexture::buildMipChain(level0);
+
+    QString bakedPath = BakedTexture::bakedPathFor(path);
+    BakedTexture baked;
+    if (!BakedTexture::write(bakedPath, path, levels, format) || !baked.open(bakedPath)) {
+        std::fprintf(stderr, "%s: failed to write %s\n", qPrintable(path), qPrintable(bakedPath));
+        return false;
+    }
+
+    size_t rgbaBytes = 0;
+    size_t compressedBytes = 0;
+    for (int i = 0; i < baked.levelCount(); ++i) {
+        rgbaBytes += size_t(levels[i].sizeInBytes());
+        compressedBytes += baked.level(i).size;
+    }
+
+    static const char *names[] = {"RGBA8", "BC1", "BC3", "BC5"};
+    std::printf("%s -> %s (%s %dx%d, %d levels, %.1f MB -> %.1f MB, %.1fx, rms error %.2f, %.1f ms)\n",
+                qPrintable(QFileInfo(path).fileName()), qPrintable(QFileInfo(bakedPath).fileName()),
+                names[int(format)], level0.width(), level0.height(), baked.levelCount(),
+                rgbaBytes / 1048576.0, compressedBytes / 1048576.0, double(rgbaBytes) / double(compressedBytes),
+                compressionError(format, level0, baked.level(0)), timer.nsecsElapsed() / 1e6);
+    return true;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QStringList inputs = app.arguments().mid(1);
+    bool reduceOverdraw = inputs.removeAll("--overdraw") > 0;
+    bool fullPrecision = inputs.removeAll("--full") > 0;
+    bool bakeTextures = inputs.removeAll("--no-textures") == 0;
+    if (inputs.isEmpty()) {
+        std::fprintf(stderr, "usage: garden_bake [--overdraw] [--full] [--no-textures] <model.obj> [more.obj ...]\n");
+        return 1;
+    }
+
+    ObjParser parser;
+    int failures = 0;
+    QMap<QString, bool> textures;  // path -> is a normal map, models share textures so bake each once
+    for (const QString &objPath : inputs) {
+        QElapsedTimer timer;
+        timer.start();
+
+        MeshData mesh;
+        if (!parser.parse(objPath, mesh)) {
+            std::fprintf(stderr, "%s: %s\n", qPrintable(objPath), qPrintable(parser.getError()));
+            ++failures;
+            continue;
+        }
+
+        MeshOptimizer::Report report = MeshOptimizer::optimize(mesh, reduceOverdraw);
+
+        // Per asset choice, meshes that quantize badly stay full precision
+        std::vector<CompactVertex> compact;
+        QuantizationError error;
+        bool isCompact = !fullPrecision && VertexQuantizer::tryQuantize(mesh, compact, error);
+
+        QString bakedPath = BakedMesh::bakedPathFor(objPath);
+        if (!BakedMesh::write(bakedPath, objPath, mesh, isCompact ? &compact : nullptr)) {
+            std::fprintf(stderr, "%s: failed to write %s\n", qPrintable(objPath), qPrintable(bakedPath));
+            ++failures;
+            continue;
+        }
+
+        std::printf("%s -> %s (%zu vertices from %zu corners, %.2fx dedup, %zu indices, %.1f ms)\n",
+                    qPrintable(QFileInfo(objPath).fileName()), qPrintable(QFileInfo(bakedPath).fileName()),
+                    mesh.vertices.size(), mesh.sourceCornerCount, mesh.compressionRatio(),
+                    mesh.indices.size(), timer.nsecsElapsed() / 1e6);
+        std::printf("    ACMR %.3f -> %.3f, ATVR %.3f -> %.3f%s\n",
+                    report.before.acmr, report.after.acmr, report.before.atvr, report.after.atvr,
+                    reduceOverdraw ? " (overdraw sorted)" : "");
+        if (!fullPrecision) {
+            std::printf("    %s vertices, max error position %.6f normal %.3f deg uv %.6f\n",
+                        isCompact ? "compact" : "full (over tolerance)",
+                        error.position, error.normalDegrees, error.texCoord);
+        }
+
+        if (!mesh.material.diffuseMap.isEmpty()) textures.insert(mesh.material.diffuseMap, false);
+        if (!mesh.material.normalMap.isEmpty()) textures.insert(mesh.material.normalMap, true);
+    }
+
+    if (bakeTextures) {
+        // A missing image is only a warning, the runtime falls back to decoding the source
+        for (auto it = textures.constBegin(); it != textures.constEnd(); ++it) {
+            bakeTexture(it.key(), it.value());
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
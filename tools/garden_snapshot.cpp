@@ -0,0 +1,256 @@
+//
+// Created by Raphael Russo on 10/17/26.
+//
+// Headless renderer: loads a .garden file, draws it through SceneRenderer into an FBO on an
+// offscreen surface from each camera pose and saves <out>/<garden>_<pose>.png. Every pose is
+// drawn --frames times after one warm-up frame, and the CPU submit, GPU and total (through
+// glFinish) time of those frames is reported, so it doubles as a benchmark under llvmpipe.
+// A poses file has one "eyeX eyeY eyeZ targetX targetY targetZ" per line, # starts a comment.
+// Without one the garden is shot from 8 points on an orbit around its centre.
+// --profile writes the per pass CPU/GPU times of the timed frames (FrameProfiler's CSV), the
+// same format the app's Profiler dock exports, for comparing builds.
+// Usage: garden_snapshot [--size WxH] [--poses file] [--frames N] [--out dir] [--no-images]
+//                        [--resources dir] [--profile csv] <garden file>
+//
+
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QGuiApplication>
+#include <QImage>
+#include <QTextStream>
+#include <QThread>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "offscreentarget.h"
+#include "model/gardenmodel.h"
+#include "renderer/assetcache.h"
+#include "renderer/scenerenderer.h"
+
+namespace {
+
+struct Pose {
+    QVector3D eye;
+    QVector3D target;
+};
+
+// Milliseconds of one kind of timing over a pose's frames
+struct Timing {
+    double sum = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    int count = 0;
+
+    void add(double ms) {
+        min = count == 0 ? ms : std::min(min, ms);
+        max = count == 0 ? ms : std::max(max, ms);
+        sum += ms;
+        ++count;
+    }
+    double mean() const { return count > 0 ? sum / count : 0.0; }
+};
+
+bool readPoses(const QString &path, std::vector<Pose> &poses) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return false;
+
+    QTextStream in(&file);
+    int lineNumber = 0;
+    while (!in.atEnd()) {
+        QString line = in.readLine();
+        ++lineNumber;
+        line = line.left(line.indexOf('#')).trimmed();
+        if (line.isEmpty()) continue;
+
+        QStringList fields = line.split(' ', Qt::SkipEmptyParts);
+        float values[6];
+        bool valid = fields.size() == 6;
+        for (int i = 0; valid && i < 6; ++i) values[i] = fields[i].toFloat(&valid);
+        if (!valid) {
+            std::fprintf(stderr, "%s:%d: expected eyeX eyeY eyeZ targetX targetY targetZ\n",
+                         qPrintable(path), lineNumber);
+            return false;
+        }
+        poses.push_back({QVector3D(values[0], values[1], values[2]), QVector3D(values[3], values[4], values[5])});
+    }
+    return !poses.empty();
+}
+
+std::vector<Pose> orbitPoses(int gridSize) {
+    // Same height and distance as the app's starting view, scaled with the garden
+    QVector3D centre(gridSize * 0.5f, 0.0f, gridSize * 0.5f);
+    float radius = gridSize * 1.1f;
+    float height = gridSize * 1.1f;
+    std::vector<Pose> poses;
+    for (int i = 0; i < 8; ++i) {
+        float angle = float(i) * float(M_PI) / 4.0f;
+        poses.push_back({centre + QVector3D(radius * std::cos(angle), height, radius * std::sin(angle)), centre});
+    }
+    return poses;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    QGuiApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addPositionalArgument("garden", "The .garden file to render");
+    QCommandLineOption sizeOption("size", "Image size", "WxH", "800x600");
+    QCommandLineOption posesOption("poses", "Camera poses, one per line", "file");
+    QCommandLineOption framesOption("frames", "Timed frames per pose", "N", "10");
+    QCommandLineOption outOption("out", "Directory the PNGs go to", "dir", ".");
+    QCommandLineOption noImagesOption("no-images", "Only time the frames");
+    QCommandLineOption resourcesOption("resources", "Checkout with the shaders and models", "dir",
+                                       SceneRenderer::DefaultResourceDir);
+    QCommandLineOption profileOption("profile", "Per pass timings of the timed frames", "csv");
+    parser.addOptions({sizeOption, posesOption, framesOption, outOption, noImagesOption, resourcesOption,
+                       profileOption});
+    parser.addHelpOption();
+    parser.process(app);
+
+    if (parser.positionalArguments().size() != 1) {
+        parser.showHelp(1);
+    }
+    QString gardenPath = parser.positionalArguments().first();
+
+    QStringList size = parser.value(sizeOption).split('x');
+    int width = size.size() == 2 ? size[0].toInt() : 0;
+    int height = size.size() == 2 ? size[1].toInt() : 0;
+    int frames = parser.value(framesOption).toInt();
+    if (width <= 0 || height <= 0 || frames <= 0) {
+        std::fprintf(stderr, "bad --size or --frames\n");
+        return 1;
+    }
+    bool saveImages = !parser.isSet(noImagesOption);
+    QDir outDir(parser.value(outOption));
+    if (saveImages && !outDir.mkpath(".")) {
+        std::fprintf(stderr, "can't create %s\n", qPrintable(outDir.path()));
+        return 1;
+    }
+
+    OffscreenTarget target(width, height);
+    if (!target.isValid()) {
+        std::fprintf(stderr, "%s\n", target.getError());
+        return 1;
+    }
+    QOpenGLFunctions_3_3_Core &gl = target.gl();
+    std::printf("%s, %dx%d, %d frames per pose\n", reinterpret_cast<const char*>(gl.glGetString(GL_RENDERER)),
+                width, height, frames);
+
+    GardenModel garden;
+    garden.setModelDirectory(parser.value(resourcesOption) + "/models/plants");
+    if (!garden.loadGarden(gardenPath)) {
+        std::fprintf(stderr, "can't read %s\n", qPrintable(gardenPath));
+        return 1;
+    }
+
+    std::vector<Pose> poses;
+    if (parser.isSet(posesOption)) {
+        if (!readPoses(parser.value(posesOption), poses)) {
+            std::fprintf(stderr, "no poses in %s\n", qPrintable(parser.value(posesOption)));
+            return 1;
+        }
+    } else {
+        poses = orbitPoses(garden.getGridSize());
+    }
+
+    int failures = 0;
+    {
+        // Scoped so its GL objects go before the context does
+        SceneRenderer scene(parser.value(resourcesOption));
+        if (!scene.initialize()) return 1;
+        scene.setTemperature(garden.getCurrentTemperature());
+        scene.setMoisture(garden.getCurrentMoisture());
+        scene.syncPlants(garden);
+        scene.setLights(garden.getLights());
+
+        // Snapshots shouldn't have placeholders in them, so everything is resident first
+        QElapsedTimer loadTimer;
+        loadTimer.start();
+        while (AssetCache::instance().loader().isBusy()) {
+            AssetCache::instance().processUploads(1000000000);
+            QThread::msleep(1);
+        }
+        AssetCache::instance().processUploads(1000000000);
+        std::printf("%d plants loaded in %.1f ms, beds %s\n\n", scene.plantCount(), loadTimer.nsecsElapsed() / 1e6,
+                    scene.usesStaticBeds(garden.getGridSize()) ? "static" : "instanced");
+
+        GLuint query;
+        gl.glGenQueries(1, &query);
+
+        // Only the timed frames are profiled, the history keeps the last FrameProfiler::HistorySize
+        FrameProfiler &profiler = scene.profiler();
+        bool profiling = parser.isSet(profileOption);
+
+        Camera camera(float(width) / float(height));
+        std::printf("%4s %24s %24s %24s\n", "pose", "cpu ms mean/min/max", "gpu ms mean/min/max",
+                    "total ms mean/min/max");
+        Timing allCpu, allGpu, allTotal;
+        for (size_t p = 0; p < poses.size(); ++p) {
+            camera.setPosition(poses[p].eye);
+            camera.setTarget(poses[p].target);
+
+            Timing cpu, gpu, total;
+            for (int frame = 0; frame <= frames; ++frame) {
+                // The last pose's frames are read back first, enabling again would drop them
+                if (frame == 0) profiler.collect();
+                profiler.setEnabled(profiling && frame > 0);
+                QElapsedTimer timer;
+                timer.start();
+                gl.glBeginQuery(GL_TIME_ELAPSED, query);
+                scene.render(camera, garden.getGridSize());
+                gl.glEndQuery(GL_TIME_ELAPSED);
+                qint64 submitNs = timer.nsecsElapsed();
+                gl.glFinish();
+                qint64 totalNs = timer.nsecsElapsed();
+
+                GLuint64 gpuNs = 0;
+                gl.glGetQueryObjectui64v(query, GL_QUERY_RESULT, &gpuNs);
+                if (frame == 0) continue;  // warm-up, first binds and uploads for this view
+
+                cpu.add(submitNs / 1e6);
+                gpu.add(gpuNs / 1e6);
+                total.add(totalNs / 1e6);
+            }
+            allCpu.add(cpu.mean());
+            allGpu.add(gpu.mean());
+            allTotal.add(total.mean());
+            std::printf("%4zu %8.2f %7.2f %7.2f %8.2f %7.2f %7.2f %8.2f %7.2f %7.2f\n", p,
+                        cpu.mean(), cpu.min, cpu.max, gpu.mean(), gpu.min, gpu.max,
+                        total.mean(), total.min, total.max);
+
+            if (saveImages) {
+                QImage image(width, height, QImage::Format_RGBA8888);
+                gl.glPixelStorei(GL_PACK_ALIGNMENT, 1);
+                gl.glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, image.bits());
+                // GL rows start at the bottom
+                QString path = outDir.filePath(QString("%1_%2.png").arg(QFileInfo(gardenPath).completeBaseName())
+                                                                   .arg(p));
+                if (!image.mirrored().save(path)) {
+                    std::fprintf(stderr, "failed to write %s\n", qPrintable(path));
+                    ++failures;
+                }
+            }
+        }
+        std::printf("\n%4s %8.2f %7.2f %7.2f %8.2f %7.2f %7.2f %8.2f %7.2f %7.2f\n", "all",
+                    allCpu.mean(), allCpu.min, allCpu.max, allGpu.mean(), allGpu.min, allGpu.max,
+                    allTotal.mean(), allTotal.min, allTotal.max);
+
+        if (profiling) {
+            profiler.collect();
+            if (!profiler.writeCsv(parser.value(profileOption))) {
+                std::fprintf(stderr, "failed to write %s\n", qPrintable(parser.value(profileOption)));
+                ++failures;
+            }
+        }
+
+        gl.glDeleteQueries(1, &query);
+    }
+
+    return failures == 0 ? 0 : 1;
+}